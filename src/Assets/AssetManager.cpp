@@ -59,27 +59,27 @@ bool AssetManager::loadManifest(const std::string &path)
     return manifestLoaded_;
 }
 
-std::shared_ptr<Texture> AssetManager::loadTextureById(const std::string &id)
+TextureHandle AssetManager::loadTextureById(const std::string &id)
 {
     auto it = texturesById_.find(id);
-    if (it != texturesById_.end())
+    if (it != texturesById_.end() && resolve(it->second))
         return it->second;
 
     if (!manifest_)
     {
         std::printf("AssetManager: manifest not loaded (texture id '%s')\n", id.c_str());
-        return nullptr;
+        return InvalidTexture;
     }
 
     const std::string *path = manifest_->texturePath(id);
     if (!path)
     {
         std::printf("AssetManager: texture id '%s' not found in manifest\n", id.c_str());
-        return nullptr;
+        return InvalidTexture;
     }
 
-    auto tex = loadTexture(*path);
-    if (tex)
+    TextureHandle tex = loadTexture(*path);
+    if (tex != InvalidTexture)
     {
         texturesById_[id] = tex;
         texturePathById_[id] = *path;
@@ -87,20 +87,17 @@ std::shared_ptr<Texture> AssetManager::loadTextureById(const std::string &id)
     return tex;
 }
 
-std::shared_ptr<Texture> AssetManager::loadTexture(const std::string &path)
+TextureHandle AssetManager::loadTexture(const std::string &path)
 {
     auto it = textures_.find(path);
-    if (it != textures_.end())
-    {
-        if (auto existing = it->second.lock())
-            return existing;
-    }
+    if (it != textures_.end() && resolve(it->second))
+        return it->second;
 
     SDL_Surface *surf = IMG_Load(path.c_str());
     if (!surf)
     {
         std::printf("IMG_Load failed for '%s': %s\n", path.c_str(), IMG_GetError());
-        return nullptr;
+        return InvalidTexture;
     }
 
     SDL_Texture *sdlTex = SDL_CreateTextureFromSurface(renderer_.native(), surf);
@@ -108,10 +105,10 @@ std::shared_ptr<Texture> AssetManager::loadTexture(const std::string &path)
     {
         std::printf("SDL_CreateTextureFromSurface failed: %s\n", SDL_GetError());
         SDL_FreeSurface(surf);
-        return nullptr;
+        return InvalidTexture;
     }
 
-    auto tex = std::make_shared<Texture>();
+    auto tex = std::make_unique<Texture>();
     tex->native_ = sdlTex;
     tex->width_ = surf->w;
     tex->height_ = surf->h;
@@ -120,8 +117,78 @@ std::shared_ptr<Texture> AssetManager::loadTexture(const std::string &path)
 
     SDL_FreeSurface(surf);
 
-    textures_[path] = tex;
-    return tex;
+    TextureHandle handle = addTexture(std::move(tex));
+    if (handle == InvalidTexture)
+    {
+        SDL_DestroyTexture(sdlTex);
+        return InvalidTexture;
+    }
+    textures_[path] = handle;
+    return handle;
+}
+
+TextureHandle AssetManager::addTexture(std::unique_ptr<Texture> tex)
+{
+    if (textureSlots_.empty())
+        textureSlots_.resize(1); // índice 0 nunca é usado: handle 0 = InvalidTexture
+
+    std::uint32_t index = 0;
+    if (!freeTextureSlots_.empty())
+    {
+        index = freeTextureSlots_.back();
+        freeTextureSlots_.pop_back();
+    }
+    else
+    {
+        if (textureSlots_.size() > TextureIndexMask)
+        {
+            std::printf("AssetManager: texture limit reached (%u)\n", TextureIndexMask);
+            return InvalidTexture;
+        }
+        index = (std::uint32_t)textureSlots_.size();
+        textureSlots_.push_back(TextureSlot{});
+    }
+
+    TextureSlot &slot = textureSlots_[index];
+    slot.texture = std::move(tex);
+    textureCount_++;
+    return MakeTextureHandle(index, slot.generation);
+}
+
+Texture *AssetManager::resolve(TextureHandle handle) const
+{
+    std::uint32_t index = TextureIndex(handle);
+    if (index == 0 || index >= textureSlots_.size())
+        return nullptr;
+    const TextureSlot &slot = textureSlots_[index];
+    if (slot.generation != TextureGeneration(handle))
+        return nullptr;
+    return slot.texture.get();
+}
+
+const Texture *AssetManager::texture(TextureHandle handle) const
+{
+    return resolve(handle);
+}
+
+void AssetManager::unloadTexture(TextureHandle handle)
+{
+    Texture *tex = resolve(handle);
+    if (!tex)
+        return;
+
+    if (tex->native_)
+        SDL_DestroyTexture(tex->native_);
+    auto it = textures_.find(tex->path_);
+    if (it != textures_.end() && it->second == handle)
+        textures_.erase(it);
+
+    std::uint32_t index = TextureIndex(handle);
+    TextureSlot &slot = textureSlots_[index];
+    slot.texture.reset();
+    slot.generation = (slot.generation + 1) & TextureGenerationMask;
+    freeTextureSlots_.push_back(index);
+    textureCount_--;
 }
 
 std::shared_ptr<Font> AssetManager::loadFontById(const std::string &id)
@@ -182,17 +249,11 @@ std::shared_ptr<Font> AssetManager::loadFont(const std::string &path, int ptSize
 
 void AssetManager::clear()
 {
-    // destruir texturas
-    for (auto &kv : textures_)
+    // destruir texturas (handles antigos passam a resolver para nullptr)
+    for (std::uint32_t i = 1; i < textureSlots_.size(); ++i)
     {
-        if (auto t = kv.second.lock())
-        {
-            if (t->native_)
-            {
-                SDL_DestroyTexture(t->native_);
-                t->native_ = nullptr;
-            }
-        }
+        if (textureSlots_[i].texture)
+            unloadTexture(MakeTextureHandle(i, textureSlots_[i].generation));
     }
     textures_.clear();
     texturesById_.clear();
@@ -248,7 +309,7 @@ bool AssetManager::reloadTextureInPlace(Texture &tex)
     return true;
 }
 
-bool AssetManager::reloadTextureFromPath(Texture &tex, const std::string &newPath, const std::shared_ptr<Texture> &handle)
+bool AssetManager::reloadTextureFromPath(Texture &tex, const std::string &newPath, TextureHandle handle)
 {
     SDL_Surface *surf = IMG_Load(newPath.c_str());
     if (!surf)
@@ -369,8 +430,8 @@ void AssetManager::updateHotReload()
                     auto itPath = texturePathById_.find(kv.first);
                     if (itPath == texturePathById_.end() || itPath->second != *path)
                     {
-                        if (kv.second)
-                            reloadTextureFromPath(*kv.second, *path, kv.second);
+                        if (Texture *tex = resolve(kv.second))
+                            reloadTextureFromPath(*tex, *path, kv.second);
                         texturePathById_[kv.first] = *path;
                     }
                 }
@@ -394,9 +455,9 @@ void AssetManager::updateHotReload()
         }
     }
 
-    for (auto &kv : textures_)
+    for (auto &slot : textureSlots_)
     {
-        if (auto t = kv.second.lock())
+        if (Texture *t = slot.texture.get())
         {
             auto now = SafeLastWrite(t->path_);
             if (now != fs::file_time_type{} && now != t->lastWrite_ && IsStable(t->path_, now))
@@ -2,7 +2,9 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include <filesystem>
+#include "TextureHandle.h"
 
 class Texture;
 class Font;
@@ -18,8 +20,13 @@ public:
 
     bool loadManifest(const std::string &path);
 
-    std::shared_ptr<Texture> loadTextureById(const std::string &id);
-    std::shared_ptr<Texture> loadTexture(const std::string &path);
+    // Texturas ficam residentes até unloadTexture/clear; o AssetManager é o
+    // dono, entidades guardam só o handle.
+    TextureHandle loadTextureById(const std::string &id);
+    TextureHandle loadTexture(const std::string &path);
+    void unloadTexture(TextureHandle handle);
+    const Texture *texture(TextureHandle handle) const;
+    std::size_t textureCount() const { return textureCount_; }
 
     // novo
     std::shared_ptr<Font> loadFontById(const std::string &id);
@@ -38,8 +45,17 @@ private:
     std::filesystem::file_time_type manifestLastWrite_{};
     bool manifestLoaded_ = false;
 
-    std::unordered_map<std::string, std::weak_ptr<Texture>> textures_;
-    std::unordered_map<std::string, std::shared_ptr<Texture>> texturesById_;
+    struct TextureSlot
+    {
+        std::unique_ptr<Texture> texture;
+        std::uint32_t generation = 0;
+    };
+
+    std::vector<TextureSlot> textureSlots_; // indexado por TextureIndex; slot 0 reservado
+    std::vector<std::uint32_t> freeTextureSlots_;
+    std::size_t textureCount_ = 0;
+    std::unordered_map<std::string, TextureHandle> textures_; // path -> handle
+    std::unordered_map<std::string, TextureHandle> texturesById_;
     std::unordered_map<std::string, std::string> texturePathById_;
 
     // novo: chave = "path|size"
@@ -48,7 +64,9 @@ private:
     std::unordered_map<std::string, FontDef> fontDefById_;
 
     bool reloadTextureInPlace(Texture &tex);
-    bool reloadTextureFromPath(Texture &tex, const std::string &newPath, const std::shared_ptr<Texture> &handle);
+    bool reloadTextureFromPath(Texture &tex, const std::string &newPath, TextureHandle handle);
+    TextureHandle addTexture(std::unique_ptr<Texture> tex);
+    Texture *resolve(TextureHandle handle) const;
     bool reloadFontInPlace(Font &font);
     bool reloadFontFromDef(Font &font, const FontDef &def, const std::shared_ptr<Font> &handle);
 };
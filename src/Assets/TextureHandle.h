@@ -0,0 +1,19 @@
+#pragma once
+#include <cstdint>
+
+// Handle de textura de 32 bits: índice na tabela do AssetManager (bits
+// baixos) + geração (bits altos). Descarregar a textura avança a geração,
+// então handles antigos resolvem para nullptr. 0 = nenhuma textura.
+using TextureHandle = std::uint32_t;
+
+constexpr TextureHandle InvalidTexture = 0;
+constexpr int TextureIndexBits = 20;
+constexpr std::uint32_t TextureIndexMask = (1u << TextureIndexBits) - 1u;
+constexpr std::uint32_t TextureGenerationMask = (1u << (32 - TextureIndexBits)) - 1u;
+
+inline std::uint32_t TextureIndex(TextureHandle h) { return h & TextureIndexMask; }
+inline std::uint32_t TextureGeneration(TextureHandle h) { return h >> TextureIndexBits; }
+inline TextureHandle MakeTextureHandle(std::uint32_t index, std::uint32_t generation)
+{
+    return (generation << TextureIndexBits) | (index & TextureIndexMask);
+}
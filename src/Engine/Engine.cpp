@@ -41,7 +41,40 @@ static Key ToKey(SDL_Keycode k)
     }
 }
 
-Engine::Engine() = default;
+Engine::Engine()
+{
+    registerRenderSystems();
+}
+
+void Engine::registerRenderSystems()
+{
+    // World em dia antes de quem lê WorldTransform; o tilemap não depende
+    // dele e roda em paralelo.
+    SystemAccess transforms;
+    transforms.readComponents = ComponentTransform | ComponentParent;
+    transforms.writeComponents = ComponentWorldTransform;
+    renderScheduler_.add("transform", transforms, [this]()
+                         { transformSystem_.update(scene_); });
+
+    SystemAccess tilemap;
+    tilemap.readResources = ResourceCamera | ResourceTilemaps;
+    renderScheduler_.add("tilemap", tilemap, [this]()
+                         { tilemapSystem_.render(*this, scene_, tilemapCommands_); });
+
+    SystemAccess sprites;
+    sprites.readComponents = ComponentWorldTransform | ComponentRect | ComponentSprite;
+    renderScheduler_.add("render", sprites, [this]()
+                         { renderSystem_.render(*this, scene_, spriteCommands_); });
+
+    SystemAccess debug;
+    debug.readComponents = ComponentWorldTransform | ComponentCollider;
+    renderScheduler_.add("physics.debug", debug, [this]()
+                         {
+                             if (physicsDebugDraw_)
+                                 physicsSystem_.debugRender(scene_, debugCommands_);
+                             else
+                                 debugCommands_.clear(); });
+}
 
 Engine::~Engine()
 {
@@ -162,7 +195,10 @@ void Engine::tick(float dt)
     {
         if (currentScene_)
             currentScene_->onFixedUpdate(*this, time_.fixedDelta());
-        physicsSystem_.step(*this, scene_, time_.fixedDelta(), currentScene_.get());
+        transformSystem_.update(scene_);
+        physicsSystem_.step(workers_, scene_, time_.fixedDelta());
+        physicsSystem_.dispatchEvents(*this, currentScene_.get());
+        entityCommands_.playback();
         time_.consumeFixedStep();
         steps++;
     }
@@ -170,6 +206,15 @@ void Engine::tick(float dt)
     // Update variavel (1x por frame)
     if (currentScene_)
         currentScene_->onUpdate(*this, time_.deltaTime());
+    entityCommands_.playback();
+}
+
+float Engine::renderAlpha() const
+{
+    if (time_.fixedDelta() <= 0.0f)
+        return 1.0f;
+    float alpha = time_.accumulator() / time_.fixedDelta();
+    return alpha < 0.0f ? 0.0f : (alpha > 1.0f ? 1.0f : alpha);
 }
 
 void Engine::renderWorld(bool includeSceneUI)
@@ -185,11 +230,12 @@ void Engine::renderWorld(bool includeSceneUI, int viewW, int viewH)
     commandBuffer_.nextFrame(time_.frameCount());
     commandBuffer_.clear();
 
-    // Tilemap + RenderSystem coleta comandos do mundo
-    tilemapSystem_.render(*this, scene_);
-    renderSystem_.render(*this, scene_);
-    if (physicsDebugDraw_)
-        physicsSystem_.debugRender(*this, scene_);
+    // Transform antes de render/debug; o tilemap roda em paralelo
+    renderScheduler_.run(workers_);
+    scene_.advanceChangeTick(); // fecha a janela lida pelos sistemas de render
+    commandBuffer_.submit(tilemapCommands_);
+    commandBuffer_.submit(spriteCommands_);
+    commandBuffer_.submit(debugCommands_);
 
     if (includeSceneUI && currentScene_)
         currentScene_->onRenderUI(*this);
@@ -262,6 +308,7 @@ bool Engine::init()
 
     assets_ = std::make_unique<AssetManager>(*backendRenderer_);
     assets_->loadManifest("assets/manifest.txt");
+    backendRenderer_->setAssets(assets_.get());
 
     input_.setAxisMapping("MoveX", AxisMapping{
                                        /*positive*/ {Key::D, Key::Right},
@@ -288,6 +335,8 @@ bool Engine::init()
 
 void Engine::shutdown()
 {
+    if (backendRenderer_)
+        backendRenderer_->setAssets(nullptr);
     assets_.reset();
     renderer_.reset();
     backendRenderer_ = nullptr;
@@ -331,27 +380,11 @@ void Engine::applyPendingScene()
     if (currentScene_)
         currentScene_->onExit(*this);
 
+    entityCommands_.clear();
     scene_.clear();
     currentScene_ = std::move(pendingScene_);
     physicsSystem_.reset();
+    transformSystem_.reset();
     if (currentScene_)
         currentScene_->onEnter(*this);
 }
-
-Entity &Engine::createEntity()
-{
-    Entity e;
-    e.id = nextEntityId_++;
-    entities_.push_back(e);
-    return entities_.back();
-}
-
-Entity *Engine::findEntity(int id)
-{
-    for (auto &e : entities_)
-    {
-        if (e.id == id)
-            return &e;
-    }
-    return nullptr;
-}
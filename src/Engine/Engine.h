@@ -12,12 +12,16 @@ union SDL_Event;
 #include "../Time/Time.h"
 #include "../Assets/AssetManager.h"
 #include "../World/Scene.h"
+#include "../World/EntityCommandBuffer.h"
 #include "../World/IScene.h"
 #include "../Systems/RenderSystem.h"
 #include "../Systems/TilemapSystem.h"
 #include "../Systems/PhysicsSystem.h"
+#include "../Systems/TransformSystem.h"
 #include "../Renderer/CommandBuffer.h"
 #include "Camera2D.h"
+#include "SystemScheduler.h"
+#include "ThreadPool.h"
 
 class Engine
 {
@@ -51,11 +55,6 @@ public:
         wy = (sy - (height_ * 0.5f)) / camera_.zoom + camera_.y;
     }
 
-    // World
-    Entity &createEntity();
-    Entity *findEntity(int id);
-    const std::vector<Entity> &entities() const { return entities_; }
-
     CommandBuffer &commandBuffer() { return commandBuffer_; }
     const CommandBuffer &commandBuffer() const { return commandBuffer_; }
 
@@ -73,20 +72,37 @@ public:
     Scene &scene() { return scene_; }
     const Scene &scene() const { return scene_; }
 
+    // Criar/destruir entidades durante callbacks e sistemas: aplicado no
+    // próximo ponto de sincronização do tick.
+    EntityCommandBuffer &commands() { return entityCommands_; }
+
     SDL_Window *nativeWindow() const { return window_; }
     SDL_Renderer *nativeSDLRenderer() const { return sdlRenderer_; }
 
     PhysicsSystem &physics() { return physicsSystem_; }
     const PhysicsSystem &physics() const { return physicsSystem_; }
     const PhysicsStats &physicsStats() const { return physicsSystem_.stats(); }
+    const RenderSystemStats &renderSystemStats() const { return renderSystem_.stats(); }
+    const TransformStats &transformStats() const { return transformSystem_.stats(); }
+    // Tempo por sistema + caminho crítico da geração de comandos do frame.
+    const SchedulerStats &renderSchedulerStats() const { return renderScheduler_.stats(); }
+
+    ThreadPool &workers() { return workers_; }
     bool physicsDebugDraw() const { return physicsDebugDraw_; }
     void setPhysicsDebugDraw(bool enabled) { physicsDebugDraw_ = enabled; }
+    // Corpos desenhados entre os dois últimos fixed steps (um step de
+    // atraso) em vez do world cru: fixed step abaixo do fps sem tremer.
+    bool renderInterpolation() const { return renderInterpolation_; }
+    void setRenderInterpolation(bool enabled) { renderInterpolation_ = enabled; }
+    // Fração do próximo fixed step já acumulada (0..1).
+    float renderAlpha() const;
 
 private:
     bool init();
     void shutdown();
     void processInput();
     void applyPendingScene();
+    void registerRenderSystems();
 
 private:
     bool running_ = false;
@@ -104,20 +120,28 @@ private:
     bool quitRequested_ = false;
     Input input_;
 
-    std::vector<Entity> entities_;
-    int nextEntityId_ = 1;
-
     Time time_;
 
     std::unique_ptr<AssetManager> assets_;
     SDLRenderer *backendRenderer_ = nullptr;
 
     Scene scene_;
+    EntityCommandBuffer entityCommands_{scene_};
     std::unique_ptr<IScene> currentScene_;
     std::unique_ptr<IScene> pendingScene_;
     TilemapSystem tilemapSystem_;
+    TransformSystem transformSystem_;
     PhysicsSystem physicsSystem_;
     RenderSystem renderSystem_;
     CommandBuffer commandBuffer_;
     bool physicsDebugDraw_ = false;
+    bool renderInterpolation_ = true;
+
+    // Cada sistema de render escreve na sua lista; o merge é feito em ordem
+    // fixa depois que todos terminam.
+    ThreadPool workers_;
+    SystemScheduler renderScheduler_;
+    std::vector<RenderCommand> tilemapCommands_;
+    std::vector<RenderCommand> spriteCommands_;
+    std::vector<RenderCommand> debugCommands_;
 };
@@ -0,0 +1,120 @@
+#include "SystemScheduler.h"
+#include "ThreadPool.h"
+#include "../Time/Stopwatch.h"
+
+void SystemScheduler::add(const char *name, const SystemAccess &access, std::function<void()> run)
+{
+    Node node;
+    node.name = name;
+    node.access = access;
+    node.run = std::move(run);
+    nodes_.push_back(std::move(node));
+    graphDirty_ = true;
+}
+
+void SystemScheduler::clear()
+{
+    nodes_.clear();
+    pending_.reset();
+    graphDirty_ = true;
+    stats_ = SchedulerStats{};
+}
+
+void SystemScheduler::buildGraph()
+{
+    int count = (int)nodes_.size();
+    for (auto &node : nodes_)
+    {
+        node.predecessors.clear();
+        node.successors.clear();
+    }
+
+    // j depende de i (i registrado antes) quando os acessos conflitam
+    for (int j = 0; j < count; ++j)
+    {
+        for (int i = 0; i < j; ++i)
+        {
+            if (!nodes_[i].access.conflictsWith(nodes_[j].access))
+                continue;
+            nodes_[j].predecessors.push_back(i);
+            nodes_[i].successors.push_back(j);
+        }
+    }
+
+    pending_.reset(new std::atomic<int>[count]);
+    stats_.systems.assign(count, SystemTiming{});
+    for (int i = 0; i < count; ++i)
+        stats_.systems[i].name = nodes_[i].name;
+    graphDirty_ = false;
+}
+
+void SystemScheduler::run(ThreadPool &pool)
+{
+    if (nodes_.empty())
+        return;
+    if (graphDirty_)
+        buildGraph();
+
+    int count = (int)nodes_.size();
+    for (int i = 0; i < count; ++i)
+        pending_[i].store((int)nodes_[i].predecessors.size());
+
+    Stopwatch frame;
+    std::atomic<int> remaining(count);
+    for (int i = 0; i < count; ++i)
+    {
+        if (nodes_[i].predecessors.empty())
+            submitNode(i, pool, remaining, frame);
+    }
+    pool.wait(remaining);
+
+    stats_.wallMs = frame.elapsedMs();
+    computeCriticalPath();
+}
+
+void SystemScheduler::submitNode(int index, ThreadPool &pool, std::atomic<int> &remaining, const Stopwatch &frame)
+{
+    pool.submit([this, index, &pool, &remaining, &frame]()
+                {
+                    SystemTiming &timing = stats_.systems[index];
+                    timing.startMs = frame.elapsedMs();
+                    nodes_[index].run();
+                    timing.ms = frame.elapsedMs() - timing.startMs;
+
+                    // libera os sucessores antes do contador deste job cair
+                    for (int next : nodes_[index].successors)
+                    {
+                        if (pending_[next].fetch_sub(1) == 1)
+                            submitNode(next, pool, remaining, frame);
+                    } },
+                &remaining);
+}
+
+void SystemScheduler::computeCriticalPath()
+{
+    // nós já estão em ordem topológica (predecessores sempre têm índice menor)
+    int count = (int)nodes_.size();
+    std::vector<float> finish(count, 0.0f);
+    std::vector<int> via(count, -1);
+    int last = -1;
+    for (int i = 0; i < count; ++i)
+    {
+        float start = 0.0f;
+        for (int p : nodes_[i].predecessors)
+        {
+            if (finish[p] > start)
+            {
+                start = finish[p];
+                via[i] = p;
+            }
+        }
+        finish[i] = start + stats_.systems[i].ms;
+        stats_.systems[i].critical = false;
+        if (last < 0 || finish[i] > finish[last])
+            last = i;
+    }
+
+    stats_.criticalPathMs = last >= 0 ? finish[last] : 0.0f;
+    for (int i = last; i >= 0; i = via[i])
+        stats_.systems[i].critical = true;
+}
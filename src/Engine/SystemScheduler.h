@@ -0,0 +1,92 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "../World/Components.h"
+
+class ThreadPool;
+class Stopwatch;
+
+// Recursos que não são componentes mas que sistemas disputam.
+using ResourceMask = std::uint32_t;
+
+enum ResourceBit : ResourceMask
+{
+    ResourceCamera = 1u << 0,
+    ResourceTilemaps = 1u << 1,
+    ResourceCommandBuffer = 1u << 2,
+    ResourceEntityCommands = 1u << 3,
+    ResourceSceneCallbacks = 1u << 4
+};
+
+// O que um sistema lê e escreve. Dois sistemas conflitam se um escreve algo
+// que o outro lê ou escreve; sem conflito eles podem rodar em paralelo.
+struct SystemAccess
+{
+    ComponentMask readComponents = 0;
+    ComponentMask writeComponents = 0;
+    ResourceMask readResources = 0;
+    ResourceMask writeResources = 0;
+
+    bool conflictsWith(const SystemAccess &o) const
+    {
+        if (writeComponents & (o.readComponents | o.writeComponents))
+            return true;
+        if (o.writeComponents & readComponents)
+            return true;
+        if (writeResources & (o.readResources | o.writeResources))
+            return true;
+        return (o.writeResources & readResources) != 0;
+    }
+};
+
+struct SystemTiming
+{
+    const char *name = "";
+    float startMs = 0.0f; // relativo ao início do run()
+    float ms = 0.0f;
+    bool critical = false; // no caminho crítico
+};
+
+struct SchedulerStats
+{
+    std::vector<SystemTiming> systems;
+    float wallMs = 0.0f;
+    float criticalPathMs = 0.0f; // soma das durações no caminho mais longo
+};
+
+// Executa sistemas num grafo de dependências montado a partir dos acessos
+// declarados. Conflitos respeitam a ordem de registro; o resto vai em
+// paralelo no ThreadPool.
+class SystemScheduler
+{
+public:
+    void add(const char *name, const SystemAccess &access, std::function<void()> run);
+    void clear();
+
+    void run(ThreadPool &pool);
+
+    const SchedulerStats &stats() const { return stats_; }
+
+private:
+    struct Node
+    {
+        const char *name = "";
+        SystemAccess access;
+        std::function<void()> run;
+        std::vector<int> predecessors;
+        std::vector<int> successors;
+    };
+
+    void buildGraph();
+    void submitNode(int index, ThreadPool &pool, std::atomic<int> &remaining, const Stopwatch &frame);
+    void computeCriticalPath();
+
+private:
+    std::vector<Node> nodes_;
+    std::unique_ptr<std::atomic<int>[]> pending_;
+    bool graphDirty_ = true;
+    SchedulerStats stats_;
+};
@@ -0,0 +1,74 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(int threadCount)
+{
+    if (threadCount <= 0)
+        threadCount = std::max(1, (int)std::thread::hardware_concurrency() - 1);
+
+    threads_.reserve(threadCount);
+    for (int i = 0; i < threadCount; ++i)
+        threads_.emplace_back([this]()
+                              { workerLoop(); });
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    for (auto &t : threads_)
+        t.join();
+}
+
+void ThreadPool::submit(std::function<void()> job, std::atomic<int> *counter)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.push_back(Job{std::move(job), counter});
+    }
+    cv_.notify_all();
+}
+
+void ThreadPool::runJob(Job &job, std::unique_lock<std::mutex> &lock)
+{
+    lock.unlock();
+    job.fn();
+    lock.lock();
+    // decrementa sob o mutex: quem espera no cv não perde o aviso
+    if (job.counter && job.counter->fetch_sub(1) == 1)
+        cv_.notify_all();
+}
+
+void ThreadPool::wait(const std::atomic<int> &counter)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (counter.load() > 0)
+    {
+        if (jobs_.empty())
+        {
+            cv_.wait(lock);
+            continue;
+        }
+        Job job = std::move(jobs_.front());
+        jobs_.pop_front();
+        runJob(job, lock);
+    }
+}
+
+void ThreadPool::workerLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true)
+    {
+        cv_.wait(lock, [this]()
+                 { return stopping_ || !jobs_.empty(); });
+        if (jobs_.empty())
+            return; // stopping_
+        Job job = std::move(jobs_.front());
+        jobs_.pop_front();
+        runJob(job, lock);
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Pool fixo de workers. Cada job pode levar um contador que é decrementado
+// quando termina; wait(counter) ajuda a executar a fila até ele chegar a 0,
+// então dá para esperar de dentro de um job sem travar o pool.
+class ThreadPool
+{
+public:
+    explicit ThreadPool(int threadCount = 0); // 0 = núcleos - 1
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    void submit(std::function<void()> job, std::atomic<int> *counter = nullptr);
+    void wait(const std::atomic<int> &counter);
+
+    int threadCount() const { return (int)threads_.size(); }
+
+private:
+    struct Job
+    {
+        std::function<void()> fn;
+        std::atomic<int> *counter = nullptr;
+    };
+
+    void workerLoop();
+    void runJob(Job &job, std::unique_lock<std::mutex> &lock);
+
+private:
+    std::vector<std::thread> threads_;
+    std::deque<Job> jobs_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+};
@@ -38,9 +38,9 @@ static void FillDebugMap(Tilemap &map)
     }
 }
 
-static int CreateObstacle(Engine &engine, float x, float y, int w, int h, unsigned char r, unsigned char g, unsigned char b)
+static EntityId CreateObstacle(Engine &engine, float x, float y, int w, int h, unsigned char r, unsigned char g, unsigned char b)
 {
-    auto &e = engine.scene().createEntity();
+    Entity e;
     e.transform.x = x;
     e.transform.y = y;
     e.rect.w = w;
@@ -49,14 +49,11 @@ static int CreateObstacle(Engine &engine, float x, float y, int w, int h, unsign
     e.rect.g = g;
     e.rect.b = b;
     e.rect.a = 255;
-    e.rect.enabled = true;
-    e.sprite.enabled = false;
-    e.collider.enabled = true;
     e.collider.w = (float)w;
     e.collider.h = (float)h;
-    e.rigidbody.enabled = true;
     e.rigidbody.isKinematic = true;
-    return e.id;
+    e.add(ComponentRect | ComponentCollider | ComponentRigidBody);
+    return engine.scene().createEntity(e);
 }
 
 static void DrawHud(Engine &engine, const Font &font, const char *sceneName)
@@ -65,6 +62,9 @@ static void DrawHud(Engine &engine, const Font &font, const char *sceneName)
     const RenderStats &stats = engine.commandBuffer().stats();
     const Camera2D &cam = engine.camera();
     const PhysicsStats &physics = engine.physicsStats();
+    const RenderSystemStats &renderSys = engine.renderSystemStats();
+    const SchedulerStats &sched = engine.renderSchedulerStats();
+    const TransformStats &transforms = engine.transformStats();
 
     float ms = time.deltaTime() * 1000.0f;
     float fps = time.fps();
@@ -75,6 +75,9 @@ static void DrawHud(Engine &engine, const Font &font, const char *sceneName)
     char line4[256];
     char line5[256];
     char line6[256];
+    char line7[256];
+    char line8[256];
+    char line9[256];
     std::snprintf(line1, sizeof(line1), "[%s] FPS: %.1f  Frame: %.2f ms", sceneName, fps, ms);
     std::snprintf(line2, sizeof(line2), "Draws: %u  Sprites: %u  Batches: %u",
                   stats.rectDraws + stats.spriteDraws, stats.spriteDraws, stats.spriteBatches);
@@ -85,8 +88,35 @@ static void DrawHud(Engine &engine, const Font &font, const char *sceneName)
     std::snprintf(line3, sizeof(line3), "Mouse: %d,%d  World: %.1f,%.1f",
                   engine.input().mouseX(), engine.input().mouseY(), wx, wy);
     std::snprintf(line4, sizeof(line4), "Camera: %.1f,%.1f  Zoom: %.2f", cam.x, cam.y, cam.zoom);
-    std::snprintf(line5, sizeof(line5), "Collisions: %d  ActivePairs: %d", physics.collisions, physics.activePairs);
+    Broadphase broadphase = engine.physics().broadphase();
+    const char *broadphaseName = broadphase == Broadphase::Tree    ? "tree"
+                                 : broadphase == Broadphase::Sweep ? "sweep"
+                                                                   : "grid";
+    int len5 = std::snprintf(line5, sizeof(line5), "Collisions: %d  ActivePairs: %d  Broadphase: %s tested %d found %d",
+                             physics.collisions, physics.activePairs, broadphaseName, physics.pairsTested, physics.collisions);
+    if (broadphase == Broadphase::Tree && len5 > 0 && len5 < (int)sizeof(line5))
+        std::snprintf(line5 + len5, sizeof(line5) - len5, " (depth %d refits %d)", physics.treeDepth, physics.treeRefits);
+    else if (broadphase == Broadphase::Sweep && len5 > 0 && len5 < (int)sizeof(line5))
+        std::snprintf(line5 + len5, sizeof(line5) - len5, " (%s)", OverlapKernelName(ActiveOverlapKernel()));
     std::snprintf(line6, sizeof(line6), "Manifest: %s", engine.assets().manifestLoaded() ? "OK" : "MISSING");
+    std::snprintf(line7, sizeof(line7), "Physics: %d bodies (%d asleep) %d colliders (%d static, %d skipped) %.3f ms  Render: %d ents (%d skipped, %d interp) %.3f ms",
+                  physics.bodiesIntegrated, physics.sleepingBodies, physics.colliders, physics.staticColliders,
+                  physics.collidersSkipped, physics.stepMs,
+                  renderSys.entitiesVisited, renderSys.entitiesSkipped, renderSys.interpolated, renderSys.buildMs);
+
+    std::snprintf(line9, sizeof(line9), "Transforms: %d nodes depth %d (%d recomputed, %d skipped) %.3f ms",
+                  transforms.nodes, transforms.maxDepth, transforms.recomputed, transforms.skipped, transforms.updateMs);
+
+    // * = no caminho crítico
+    int len = std::snprintf(line8, sizeof(line8), "Systems: wall %.3f ms crit %.3f ms |",
+                            sched.wallMs, sched.criticalPathMs);
+    for (const auto &sys : sched.systems)
+    {
+        if (len < 0 || len >= (int)sizeof(line8))
+            break;
+        len += std::snprintf(line8 + len, sizeof(line8) - len, " %s %.3f%s",
+                             sys.name, sys.ms, sys.critical ? "*" : "");
+    }
 
     engine.renderer().drawText(font, line1, 10, 10, 255, 255, 255, 255);
     engine.renderer().drawText(font, line2, 10, 32, 200, 200, 200, 255);
@@ -94,6 +124,9 @@ static void DrawHud(Engine &engine, const Font &font, const char *sceneName)
     engine.renderer().drawText(font, line4, 10, 76, 200, 200, 200, 255);
     engine.renderer().drawText(font, line5, 10, 98, 200, 200, 200, 255);
     engine.renderer().drawText(font, line6, 10, 120, 200, 200, 200, 255);
+    engine.renderer().drawText(font, line7, 10, 142, 200, 200, 200, 255);
+    engine.renderer().drawText(font, line8, 10, 164, 200, 200, 200, 255);
+    engine.renderer().drawText(font, line9, 10, 186, 200, 200, 200, 255);
 }
 
 class DemoScene : public IScene
@@ -103,26 +136,36 @@ public:
     {
         Tilemap &map = engine.scene().createTilemap(80, 80, 32);
         FillDemoMap(map);
+        map.setSolid(3, true); // borda
 
-        auto &e = engine.scene().createEntity();
+        Entity e;
         e.transform.x = 100;
         e.transform.y = 100;
 
         font_ = engine.assets().loadFontById("ui_font");
 
         e.sprite.texture = engine.assets().loadTextureById("player");
-        e.sprite.enabled = true;
         e.sprite.scale = 1.0f;
 
-        // desligar rect para nao desenhar quadrado
-        e.rect.enabled = false;
-
-        e.collider.enabled = true;
+        // sem RectRender para nao desenhar quadrado
         e.collider.w = 28.0f;
         e.collider.h = 28.0f;
-        e.rigidbody.enabled = true;
-
-        playerId_ = e.id;
+        e.add(ComponentSprite | ComponentCollider | ComponentRigidBody);
+
+        playerId_ = engine.scene().createEntity(e);
+
+        // marcador preso ao player (posição local relativa a ele)
+        Entity marker;
+        marker.transform.x = 10.0f;
+        marker.transform.y = -12.0f;
+        marker.rect.w = 8;
+        marker.rect.h = 8;
+        marker.rect.r = 255;
+        marker.rect.g = 220;
+        marker.rect.b = 60;
+        marker.rect.layer = 1;
+        marker.add(ComponentRect);
+        engine.scene().setParent(engine.scene().createEntity(marker), playerId_);
 
         CreateObstacle(engine, 300, 220, 120, 40, 80, 80, 200);
         CreateObstacle(engine, 500, 380, 40, 160, 80, 200, 120);
@@ -132,7 +175,8 @@ public:
     void onUpdate(Engine &engine, float dt) override
     {
         auto &cam = engine.camera();
-        Entity *p = engine.scene().findEntity(playerId_);
+        const Scene &scene = engine.scene();
+        const WorldTransform *p = scene.get<WorldTransform>(playerId_);
         if (!p)
             return;
 
@@ -155,8 +199,13 @@ public:
         if (!zoomOutDown && input.pressed("ZoomOut"))
             cam.zoom *= 0.90f;
 
-        cam.x = p->transform.x;
-        cam.y = p->transform.y;
+        // câmera no mesmo lugar em que o player é desenhado
+        float followX = p->x;
+        float followY = p->y;
+        if (engine.renderInterpolation())
+            engine.physics().interpolate(playerId_, *p, engine.renderAlpha(), followX, followY);
+        cam.x = followX;
+        cam.y = followY;
         if (cam.zoom < 0.1f)
             cam.zoom = 0.1f;
         if (cam.zoom > 6.0f)
@@ -166,7 +215,7 @@ public:
     void onFixedUpdate(Engine &engine, float fixedDt) override
     {
         (void)fixedDt;
-        Entity *p = engine.scene().findEntity(playerId_);
+        RigidBody2D *p = engine.scene().get<RigidBody2D>(playerId_);
         if (!p)
             return;
 
@@ -175,8 +224,8 @@ public:
         float y = input.getAxis("MoveY");
 
         float speed = 220.0f;
-        p->rigidbody.vx = x * speed;
-        p->rigidbody.vy = y * speed;
+        p->vx = x * speed;
+        p->vy = y * speed;
     }
 
     void onRenderUI(Engine &engine) override
@@ -187,7 +236,7 @@ public:
     }
 
 private:
-    int playerId_ = 0;
+    EntityId playerId_ = InvalidEntity;
     std::shared_ptr<Font> font_;
 };
 
@@ -199,7 +248,7 @@ public:
         Tilemap &map = engine.scene().createTilemap(60, 60, 40);
         FillDebugMap(map);
 
-        auto &e = engine.scene().createEntity();
+        Entity e;
         e.transform.x = 100;
         e.transform.y = 100;
 
@@ -211,26 +260,44 @@ public:
         e.rect.g = 200;
         e.rect.b = 255;
         e.rect.a = 255;
-        e.rect.enabled = true;
 
-        e.sprite.enabled = false;
-
-        e.collider.enabled = true;
         e.collider.w = 40.0f;
         e.collider.h = 40.0f;
-        e.rigidbody.enabled = true;
+        e.add(ComponentRect | ComponentCollider | ComponentRigidBody);
 
-        playerId_ = e.id;
+        playerId_ = engine.scene().createEntity(e);
 
         CreateObstacle(engine, 260, 180, 80, 80, 200, 80, 120);
         CreateObstacle(engine, 460, 260, 140, 30, 120, 80, 200);
         CreateObstacle(engine, 140, 360, 40, 160, 80, 160, 220);
+
+        // fileira de caixas: um prefab, instanciado de uma vez
+        Entity crate;
+        crate.rect.w = 24;
+        crate.rect.h = 24;
+        crate.rect.r = 180;
+        crate.rect.g = 140;
+        crate.rect.b = 90;
+        crate.collider.w = 24.0f;
+        crate.collider.h = 24.0f;
+        crate.rigidbody.isKinematic = true;
+        crate.add(ComponentRect | ComponentCollider | ComponentRigidBody);
+        PrefabHandle cratePrefab = engine.scene().createPrefab("crate", crate);
+
+        Transform row[32];
+        for (int i = 0; i < 32; ++i)
+        {
+            row[i].x = 60.0f + i * 32.0f;
+            row[i].y = 620.0f;
+        }
+        engine.scene().instantiate(cratePrefab, 32, row);
     }
 
     void onUpdate(Engine &engine, float dt) override
     {
         auto &cam = engine.camera();
-        Entity *p = engine.scene().findEntity(playerId_);
+        const Scene &scene = engine.scene();
+        const WorldTransform *p = scene.get<WorldTransform>(playerId_);
         if (!p)
             return;
 
@@ -253,8 +320,13 @@ public:
         if (!zoomOutDown && input.pressed("ZoomOut"))
             cam.zoom *= 0.90f;
 
-        cam.x = p->transform.x;
-        cam.y = p->transform.y;
+        // câmera no mesmo lugar em que o player é desenhado
+        float followX = p->x;
+        float followY = p->y;
+        if (engine.renderInterpolation())
+            engine.physics().interpolate(playerId_, *p, engine.renderAlpha(), followX, followY);
+        cam.x = followX;
+        cam.y = followY;
         if (cam.zoom < 0.1f)
             cam.zoom = 0.1f;
         if (cam.zoom > 6.0f)
@@ -264,7 +336,7 @@ public:
     void onFixedUpdate(Engine &engine, float fixedDt) override
     {
         (void)fixedDt;
-        Entity *p = engine.scene().findEntity(playerId_);
+        RigidBody2D *p = engine.scene().get<RigidBody2D>(playerId_);
         if (!p)
             return;
 
@@ -273,8 +345,8 @@ public:
         float y = input.getAxis("MoveY");
 
         float speed = 200.0f;
-        p->rigidbody.vx = x * speed;
-        p->rigidbody.vy = y * speed;
+        p->vx = x * speed;
+        p->vy = y * speed;
     }
 
     void onRenderUI(Engine &engine) override
@@ -285,7 +357,7 @@ public:
     }
 
 private:
-    int playerId_ = 0;
+    EntityId playerId_ = InvalidEntity;
     std::shared_ptr<Font> font_;
 };
 
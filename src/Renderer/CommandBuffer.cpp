@@ -1,13 +1,7 @@
 #include "CommandBuffer.h"
-#include "../Assets/Texture.h"
 #include <algorithm>
 #include <cstdint>
 
-static std::uintptr_t TexKey(const Texture *t)
-{
-    return reinterpret_cast<std::uintptr_t>(t);
-}
-
 void CommandBuffer::nextFrame(std::uint64_t frameIndex)
 {
     stats_ = RenderStats{};
@@ -29,6 +23,13 @@ void CommandBuffer::submit(const RenderCommand &cmd)
     finalized_ = false;
 }
 
+void CommandBuffer::submit(const std::vector<RenderCommand> &cmds)
+{
+    cmds_.insert(cmds_.end(), cmds.begin(), cmds.end());
+    stats_.commandsSubmitted += (std::uint32_t)cmds.size();
+    finalized_ = false;
+}
+
 void CommandBuffer::compileBatches()
 {
     spriteBatches_.clear();
@@ -37,7 +38,7 @@ void CommandBuffer::compileBatches()
 
     for (const auto &c : cmds_)
     {
-        if (c.type != RenderCommandType::Sprite || !c.texture)
+        if (c.type != RenderCommandType::Sprite || c.texture == InvalidTexture)
             continue;
 
         bool needNew =
@@ -81,7 +82,7 @@ void CommandBuffer::finalize()
                       return a.layer < b.layer;
                   if (a.type != b.type)
                       return (int)a.type < (int)b.type;
-                  return TexKey(a.texture) < TexKey(b.texture);
+                  return TextureIndex(a.texture) < TextureIndex(b.texture);
               });
 
     stats_.rectDraws = 0;
@@ -97,10 +98,10 @@ void CommandBuffer::finalize()
 
     compileBatches();
 
-    const Texture *lastTex = nullptr;
+    TextureHandle lastTex = InvalidTexture;
     for (const auto &batch : spriteBatches_)
     {
-        if (!batch.texture)
+        if (batch.texture == InvalidTexture)
             continue;
         if (batch.texture != lastTex)
         {
@@ -9,6 +9,7 @@ class CommandBuffer
 public:
     void clear();
     void submit(const RenderCommand &cmd);
+    void submit(const std::vector<RenderCommand> &cmds);
 
     void nextFrame(std::uint64_t frameIndex);
     void finalize();
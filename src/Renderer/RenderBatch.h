@@ -1,8 +1,7 @@
 #pragma once
 #include <cstdint>
 #include <vector>
-
-class Texture;
+#include "../Assets/TextureHandle.h"
 
 struct SpriteInstance
 {
@@ -19,6 +18,6 @@ struct SpriteInstance
 struct RenderBatch
 {
     int layer = 0;
-    const Texture *texture = nullptr;
+    TextureHandle texture = InvalidTexture;
     std::vector<SpriteInstance> sprites;
 };
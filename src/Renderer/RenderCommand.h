@@ -1,7 +1,6 @@
 #pragma once
 #include <cstdint>
-
-class Texture;
+#include "../Assets/TextureHandle.h"
 
 enum class RenderCommandType : std::uint8_t
 {
@@ -23,7 +22,7 @@ struct RenderCommand
     std::uint8_t r = 255, g = 255, b = 255, a = 255;
 
     // sprite
-    const Texture *texture = nullptr; // ponteiro não-dono (AssetManager mantém vivo)
+    TextureHandle texture = InvalidTexture; // resolvido no submit do backend
     float scale = 1.0f;
     bool useSrcRect = false;
     int srcX = 0;
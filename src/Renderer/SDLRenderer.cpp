@@ -1,5 +1,6 @@
 #include "SDLRenderer.h"
 #include "../Assets/Texture.h"
+#include "../Assets/AssetManager.h"
 #include <SDL.h>
 #include "../Assets/Font.h"
 #include "CommandBuffer.h"
@@ -162,9 +163,12 @@ void SDLRenderer::submit(const CommandBuffer &cmds)
     }
 
     // 2) sprite batches
+    if (!assets_)
+        return;
     for (const auto &batch : cmds.spriteBatches())
     {
-        if (!batch.texture)
+        const Texture *tex = assets_->texture(batch.texture);
+        if (!tex)
             continue;
         for (const auto &inst : batch.sprites)
         {
@@ -178,7 +182,7 @@ void SDLRenderer::submit(const CommandBuffer &cmds)
                 src.h = inst.srcH;
                 srcPtr = &src;
             }
-            drawTexture(*batch.texture, inst.x, inst.y, inst.scale, srcPtr, inst.rotationDeg);
+            drawTexture(*tex, inst.x, inst.y, inst.scale, srcPtr, inst.rotationDeg);
         }
     }
 }
@@ -10,6 +10,7 @@ struct SDL_Texture;
 
 class Texture;
 class Font;
+class AssetManager;
 
 class SDLRenderer final : public Renderer
 {
@@ -35,10 +36,13 @@ public:
     void setCamera(const Camera2D &cam, int screenW, int screenH) override;
     void submit(const CommandBuffer &cmds) override;
     void invalidateTextCache(const Font *font);
+    // Tabela usada para resolver os TextureHandle dos comandos no submit.
+    void setAssets(const AssetManager *assets) { assets_ = assets; }
     std::size_t textCacheSize() const { return textCache_.size(); }
 
 private:
     SDL_Renderer *r_ = nullptr;
+    const AssetManager *assets_ = nullptr;
     Camera2D cam_{};
     int screenW_ = 800;
     int screenH_ = 600;
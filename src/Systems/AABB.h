@@ -0,0 +1,33 @@
+#pragma once
+#include <algorithm>
+
+struct AABB
+{
+    float minX;
+    float minY;
+    float maxX;
+    float maxY;
+};
+
+inline AABB Union(const AABB &a, const AABB &b)
+{
+    return {std::min(a.minX, b.minX), std::min(a.minY, b.minY),
+            std::max(a.maxX, b.maxX), std::max(a.maxY, b.maxY)};
+}
+
+// b inteiro dentro de a (bordas contam)
+inline bool Contains(const AABB &a, const AABB &b)
+{
+    return a.minX <= b.minX && a.minY <= b.minY && b.maxX <= a.maxX && b.maxY <= a.maxY;
+}
+
+// Sobreposição fechada: caixas que só se tocam também contam (broadphase).
+inline bool Overlaps(const AABB &a, const AABB &b)
+{
+    return !(a.maxX < b.minX || a.minX > b.maxX || a.maxY < b.minY || a.minY > b.maxY);
+}
+
+inline float Perimeter(const AABB &a)
+{
+    return 2.0f * ((a.maxX - a.minX) + (a.maxY - a.minY));
+}
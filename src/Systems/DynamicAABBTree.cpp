@@ -0,0 +1,241 @@
+#include "DynamicAABBTree.h"
+
+int DynamicAABBTree::allocateNode()
+{
+    if (freeList_ == Null)
+    {
+        nodes_.emplace_back();
+        return (int)nodes_.size() - 1;
+    }
+    int id = freeList_;
+    freeList_ = nodes_[id].parent;
+    nodes_[id] = Node{};
+    return id;
+}
+
+void DynamicAABBTree::freeNode(int id)
+{
+    nodes_[id].parent = freeList_;
+    nodes_[id].height = -1;
+    freeList_ = id;
+}
+
+int DynamicAABBTree::createProxy(const AABB &box, std::uint32_t userData)
+{
+    int id = allocateNode();
+    Node &node = nodes_[id];
+    node.box = {box.minX - margin_, box.minY - margin_, box.maxX + margin_, box.maxY + margin_};
+    node.userData = userData;
+    node.height = 0;
+    insertLeaf(id);
+    proxyCount_++;
+    return id;
+}
+
+void DynamicAABBTree::destroyProxy(int proxy)
+{
+    removeLeaf(proxy);
+    freeNode(proxy);
+    proxyCount_--;
+}
+
+bool DynamicAABBTree::moveProxy(int proxy, const AABB &box, float dx, float dy)
+{
+    if (Contains(nodes_[proxy].box, box))
+        return false;
+
+    removeLeaf(proxy);
+
+    // margem + o dobro do deslocamento previsto, só na direção do movimento
+    AABB fat{box.minX - margin_, box.minY - margin_, box.maxX + margin_, box.maxY + margin_};
+    if (dx < 0.0f)
+        fat.minX += 2.0f * dx;
+    else
+        fat.maxX += 2.0f * dx;
+    if (dy < 0.0f)
+        fat.minY += 2.0f * dy;
+    else
+        fat.maxY += 2.0f * dy;
+    nodes_[proxy].box = fat;
+
+    insertLeaf(proxy);
+    return true;
+}
+
+void DynamicAABBTree::insertLeaf(int leaf)
+{
+    if (root_ == Null)
+    {
+        root_ = leaf;
+        nodes_[leaf].parent = Null;
+        return;
+    }
+
+    // Desce escolhendo o filho que menos aumenta o perímetro (custo SAH)
+    AABB leafBox = nodes_[leaf].box;
+    int index = root_;
+    while (!nodes_[index].isLeaf())
+    {
+        const Node &node = nodes_[index];
+        float area = Perimeter(node.box);
+        float combined = Perimeter(Union(node.box, leafBox));
+
+        // custo de criar um pai novo aqui / custo herdado pelos filhos
+        float cost = 2.0f * combined;
+        float inherited = 2.0f * (combined - area);
+
+        auto childCost = [&](int child)
+        {
+            const Node &c = nodes_[child];
+            float grown = Perimeter(Union(c.box, leafBox));
+            if (c.isLeaf())
+                return grown + inherited;
+            return (grown - Perimeter(c.box)) + inherited;
+        };
+        float costLeft = childCost(node.left);
+        float costRight = childCost(node.right);
+
+        if (cost < costLeft && cost < costRight)
+            break;
+        index = (costLeft < costRight) ? node.left : node.right;
+    }
+
+    int sibling = index;
+    int oldParent = nodes_[sibling].parent;
+    int newParent = allocateNode();
+    nodes_[newParent].parent = oldParent;
+    nodes_[newParent].box = Union(leafBox, nodes_[sibling].box);
+    nodes_[newParent].height = nodes_[sibling].height + 1;
+    nodes_[newParent].left = sibling;
+    nodes_[newParent].right = leaf;
+    nodes_[sibling].parent = newParent;
+    nodes_[leaf].parent = newParent;
+
+    if (oldParent != Null)
+    {
+        if (nodes_[oldParent].left == sibling)
+            nodes_[oldParent].left = newParent;
+        else
+            nodes_[oldParent].right = newParent;
+    }
+    else
+    {
+        root_ = newParent;
+    }
+
+    refitUp(nodes_[leaf].parent);
+}
+
+void DynamicAABBTree::removeLeaf(int leaf)
+{
+    if (leaf == root_)
+    {
+        root_ = Null;
+        return;
+    }
+
+    int parent = nodes_[leaf].parent;
+    int grandParent = nodes_[parent].parent;
+    int sibling = (nodes_[parent].left == leaf) ? nodes_[parent].right : nodes_[parent].left;
+
+    if (grandParent != Null)
+    {
+        if (nodes_[grandParent].left == parent)
+            nodes_[grandParent].left = sibling;
+        else
+            nodes_[grandParent].right = sibling;
+        nodes_[sibling].parent = grandParent;
+        freeNode(parent);
+        refitUp(grandParent);
+    }
+    else
+    {
+        root_ = sibling;
+        nodes_[sibling].parent = Null;
+        freeNode(parent);
+    }
+}
+
+// Sobe até a raiz balanceando e recalculando caixa/altura.
+void DynamicAABBTree::refitUp(int index)
+{
+    while (index != Null)
+    {
+        index = balance(index);
+        Node &node = nodes_[index];
+        const Node &left = nodes_[node.left];
+        const Node &right = nodes_[node.right];
+        node.height = 1 + (left.height > right.height ? left.height : right.height);
+        node.box = Union(left.box, right.box);
+        index = node.parent;
+    }
+}
+
+// Rotação quando um lado está 2+ níveis mais alto (como numa AVL). Devolve
+// o nó que passou a ocupar a posição de a.
+int DynamicAABBTree::balance(int iA)
+{
+    Node &A = nodes_[iA];
+    if (A.isLeaf() || A.height < 2)
+        return iA;
+
+    int iB = A.left;
+    int iC = A.right;
+    int diff = nodes_[iC].height - nodes_[iB].height;
+
+    auto rotate = [&](int iUp, int iOther) -> int
+    {
+        // iUp sobe para o lugar de A; o neto mais alto fica com iUp, o mais
+        // baixo desce para A
+        Node &up = nodes_[iUp];
+        int iF = up.left;
+        int iG = up.right;
+
+        up.left = iA;
+        up.parent = nodes_[iA].parent;
+        nodes_[iA].parent = iUp;
+
+        if (up.parent != Null)
+        {
+            if (nodes_[up.parent].left == iA)
+                nodes_[up.parent].left = iUp;
+            else
+                nodes_[up.parent].right = iUp;
+        }
+        else
+        {
+            root_ = iUp;
+        }
+
+        int keep = (nodes_[iF].height > nodes_[iG].height) ? iF : iG;
+        int give = (keep == iF) ? iG : iF;
+        up.right = keep;
+        if (nodes_[iA].left == iUp)
+            nodes_[iA].left = give;
+        else
+            nodes_[iA].right = give;
+        nodes_[give].parent = iA;
+
+        Node &a = nodes_[iA];
+        a.box = Union(nodes_[iOther].box, nodes_[give].box);
+        a.height = 1 + (nodes_[iOther].height > nodes_[give].height ? nodes_[iOther].height : nodes_[give].height);
+        up.box = Union(a.box, nodes_[keep].box);
+        up.height = 1 + (a.height > nodes_[keep].height ? a.height : nodes_[keep].height);
+        return iUp;
+    };
+
+    if (diff > 1)
+        return rotate(iC, iB);
+    if (diff < -1)
+        return rotate(iB, iC);
+    return iA;
+}
+
+void DynamicAABBTree::clear()
+{
+    nodes_.clear();
+    stack_.clear();
+    root_ = Null;
+    freeList_ = Null;
+    proxyCount_ = 0;
+}
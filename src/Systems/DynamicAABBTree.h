@@ -0,0 +1,95 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "AABB.h"
+
+// Árvore de AABBs persistente (broadphase). Cada proxy guarda uma caixa
+// "gorda" (margem + deslocamento previsto); mover um proxy cuja caixa real
+// ainda cabe na gorda não custa nada. Só quem sai é removido e reinserido,
+// com rotações para manter a árvore balanceada.
+class DynamicAABBTree
+{
+public:
+    static constexpr int Null = -1;
+
+    // Margem extra em volta da caixa real, em pixels.
+    void setMargin(float margin) { margin_ = margin; }
+    float margin() const { return margin_; }
+
+    int createProxy(const AABB &box, std::uint32_t userData);
+    void destroyProxy(int proxy);
+    // displacement = movimento previsto para o próximo step (estica a caixa
+    // gorda nessa direção). Devolve true se o proxy foi reinserido.
+    bool moveProxy(int proxy, const AABB &box, float dx, float dy);
+
+    std::uint32_t userData(int proxy) const { return nodes_[proxy].userData; }
+    const AABB &fatAABB(int proxy) const { return nodes_[proxy].box; }
+
+    // fn(int proxy) para cada proxy cuja caixa gorda encosta em box;
+    // fn devolve false para parar.
+    template <typename Fn>
+    void query(const AABB &box, Fn &&fn)
+    {
+        query(box, stack_, fn);
+    }
+
+    // Igual, com a pilha de quem chama (várias threads lendo a árvore).
+    template <typename Fn>
+    void query(const AABB &box, std::vector<int> &stack, Fn &&fn) const
+    {
+        if (root_ == Null)
+            return;
+        stack.clear();
+        stack.push_back(root_);
+        while (!stack.empty())
+        {
+            int id = stack.back();
+            stack.pop_back();
+            const Node &node = nodes_[id];
+            if (!Overlaps(node.box, box))
+                continue;
+            if (node.isLeaf())
+            {
+                if (!fn(id))
+                    return;
+            }
+            else
+            {
+                stack.push_back(node.left);
+                stack.push_back(node.right);
+            }
+        }
+    }
+
+    int height() const { return root_ == Null ? 0 : nodes_[root_].height; }
+    int proxyCount() const { return proxyCount_; }
+    void clear();
+
+private:
+    struct Node
+    {
+        AABB box{};
+        int parent = Null; // na lista livre: próximo livre
+        int left = Null;
+        int right = Null;
+        int height = 0; // folha = 0, livre = -1
+        std::uint32_t userData = 0;
+
+        bool isLeaf() const { return left == Null; }
+    };
+
+    int allocateNode();
+    void freeNode(int id);
+    void insertLeaf(int leaf);
+    void removeLeaf(int leaf);
+    int balance(int a);
+    void refitUp(int index);
+
+private:
+    std::vector<Node> nodes_;
+    std::vector<int> stack_;
+    int root_ = Null;
+    int freeList_ = Null;
+    int proxyCount_ = 0;
+    float margin_ = 4.0f;
+};
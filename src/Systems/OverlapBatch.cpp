@@ -0,0 +1,230 @@
+#include "OverlapBatch.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define OVERLAP_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(OVERLAP_X86) && (defined(__GNUC__) || defined(__clang__))
+#define OVERLAP_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define OVERLAP_TARGET_AVX2
+#endif
+
+using KernelFn = int (*)(const AABB &, const float *, const float *, const float *, const float *, int, int *);
+
+// Sobreposição fechada, igual a Overlaps(): encostar conta.
+static int OverlapScalar(const AABB &box, const float *minX, const float *minY,
+                         const float *maxX, const float *maxY, int count, int *out)
+{
+    int hits = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        if (minX[i] <= box.maxX && box.minX <= maxX[i] && minY[i] <= box.maxY && box.minY <= maxY[i])
+            out[hits++] = i;
+    }
+    return hits;
+}
+
+#if defined(OVERLAP_X86)
+// Posição do bit 1 mais baixo (mask != 0).
+static inline int LowestBit(unsigned mask)
+{
+#if defined(_MSC_VER)
+    unsigned long bit = 0;
+    _BitScanForward(&bit, mask);
+    return (int)bit;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+static int OverlapSSE2(const AABB &box, const float *minX, const float *minY,
+                       const float *maxX, const float *maxY, int count, int *out)
+{
+    const __m128 bMinX = _mm_set1_ps(box.minX);
+    const __m128 bMinY = _mm_set1_ps(box.minY);
+    const __m128 bMaxX = _mm_set1_ps(box.maxX);
+    const __m128 bMaxY = _mm_set1_ps(box.maxY);
+    int hits = 0;
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 x = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(minX + i), bMaxX),
+                              _mm_cmple_ps(bMinX, _mm_loadu_ps(maxX + i)));
+        __m128 y = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(minY + i), bMaxY),
+                              _mm_cmple_ps(bMinY, _mm_loadu_ps(maxY + i)));
+        unsigned mask = (unsigned)_mm_movemask_ps(_mm_and_ps(x, y));
+        while (mask)
+        {
+            out[hits++] = i + LowestBit(mask);
+            mask &= mask - 1; // apaga o bit mais baixo
+        }
+    }
+    int tail = OverlapScalar(box, minX + i, minY + i, maxX + i, maxY + i, count - i, out + hits);
+    for (int k = 0; k < tail; ++k)
+        out[hits + k] += i;
+    return hits + tail;
+}
+
+OVERLAP_TARGET_AVX2
+static int OverlapAVX2(const AABB &box, const float *minX, const float *minY,
+                       const float *maxX, const float *maxY, int count, int *out)
+{
+    const __m256 bMinX = _mm256_set1_ps(box.minX);
+    const __m256 bMinY = _mm256_set1_ps(box.minY);
+    const __m256 bMaxX = _mm256_set1_ps(box.maxX);
+    const __m256 bMaxY = _mm256_set1_ps(box.maxY);
+    int hits = 0;
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 x = _mm256_and_ps(_mm256_cmp_ps(_mm256_loadu_ps(minX + i), bMaxX, _CMP_LE_OQ),
+                                 _mm256_cmp_ps(bMinX, _mm256_loadu_ps(maxX + i), _CMP_LE_OQ));
+        __m256 y = _mm256_and_ps(_mm256_cmp_ps(_mm256_loadu_ps(minY + i), bMaxY, _CMP_LE_OQ),
+                                 _mm256_cmp_ps(bMinY, _mm256_loadu_ps(maxY + i), _CMP_LE_OQ));
+        unsigned mask = (unsigned)_mm256_movemask_ps(_mm256_and_ps(x, y));
+        while (mask)
+        {
+            out[hits++] = i + LowestBit(mask);
+            mask &= mask - 1; // apaga o bit mais baixo
+        }
+    }
+    // sobra de 4 ainda em SIMD (instruções VEX: sem penalidade de transição)
+    if (i + 4 <= count)
+    {
+        __m128 x = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(minX + i), _mm256_castps256_ps128(bMaxX)),
+                              _mm_cmple_ps(_mm256_castps256_ps128(bMinX), _mm_loadu_ps(maxX + i)));
+        __m128 y = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(minY + i), _mm256_castps256_ps128(bMaxY)),
+                              _mm_cmple_ps(_mm256_castps256_ps128(bMinY), _mm_loadu_ps(maxY + i)));
+        unsigned mask = (unsigned)_mm_movemask_ps(_mm_and_ps(x, y));
+        while (mask)
+        {
+            out[hits++] = i + LowestBit(mask);
+            mask &= mask - 1; // apaga o bit mais baixo
+        }
+        i += 4;
+    }
+    int tail = OverlapScalar(box, minX + i, minY + i, maxX + i, maxY + i, count - i, out + hits);
+    for (int k = 0; k < tail; ++k)
+        out[hits + k] += i;
+    return hits + tail;
+}
+
+static bool CpuHasAVX2()
+{
+#if defined(_MSC_VER)
+    int info[4] = {};
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx)
+        return false;
+    // o SO salva os registradores YMM?
+    if ((_xgetbv(0) & 0x6) != 0x6)
+        return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+#endif
+
+bool OverlapKernelSupported(OverlapKernel kernel)
+{
+    switch (kernel)
+    {
+    case OverlapKernel::Scalar:
+        return true;
+#if defined(OVERLAP_X86)
+    case OverlapKernel::SSE2:
+        return true; // base do x86-64; o engine não roda em x86 sem SSE2
+    case OverlapKernel::AVX2:
+    {
+        static const bool avx2 = CpuHasAVX2();
+        return avx2;
+    }
+#endif
+    default:
+        return false;
+    }
+}
+
+static KernelFn KernelFor(OverlapKernel kernel)
+{
+#if defined(OVERLAP_X86)
+    if (kernel == OverlapKernel::AVX2)
+        return OverlapAVX2;
+    if (kernel == OverlapKernel::SSE2)
+        return OverlapSSE2;
+#endif
+    return OverlapScalar;
+}
+
+// AVX2 não entra sozinho: no overlap_bench (-O2) fica ~3.3 ns/teste contra
+// ~2.2 do SSE2. Continua disponível via SetOverlapKernel.
+static OverlapKernel BestKernel()
+{
+    if (OverlapKernelSupported(OverlapKernel::SSE2))
+        return OverlapKernel::SSE2;
+    return OverlapKernel::Scalar;
+}
+
+static OverlapKernel &Active()
+{
+    static OverlapKernel kernel = BestKernel();
+    return kernel;
+}
+
+static KernelFn &ActiveFn()
+{
+    static KernelFn fn = KernelFor(Active());
+    return fn;
+}
+
+OverlapKernel ActiveOverlapKernel()
+{
+    return Active();
+}
+
+bool SetOverlapKernel(OverlapKernel kernel)
+{
+    if (!OverlapKernelSupported(kernel))
+        return false;
+    Active() = kernel;
+    ActiveFn() = KernelFor(kernel);
+    return true;
+}
+
+const char *OverlapKernelName(OverlapKernel kernel)
+{
+    switch (kernel)
+    {
+    case OverlapKernel::SSE2:
+        return "sse2";
+    case OverlapKernel::AVX2:
+        return "avx2";
+    default:
+        return "scalar";
+    }
+}
+
+int OverlapBatch(const AABB &box, const BoundsSoA &bounds, int begin, int end, int *out)
+{
+    int count = end - begin;
+    if (count <= 0)
+        return 0;
+    int hits = ActiveFn()(box, bounds.minX.data() + begin, bounds.minY.data() + begin,
+                          bounds.maxX.data() + begin, bounds.maxY.data() + begin, count, out);
+    for (int k = 0; k < hits; ++k)
+        out[k] += begin;
+    return hits;
+}
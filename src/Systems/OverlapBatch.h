@@ -0,0 +1,50 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "AABB.h"
+
+// Bounds em SoA (um array por lado), para testar uma caixa contra vários
+// candidatos seguidos de uma vez.
+struct BoundsSoA
+{
+    std::vector<float> minX;
+    std::vector<float> minY;
+    std::vector<float> maxX;
+    std::vector<float> maxY;
+
+    std::size_t size() const { return minX.size(); }
+    void resize(std::size_t count)
+    {
+        minX.resize(count);
+        minY.resize(count);
+        maxX.resize(count);
+        maxY.resize(count);
+    }
+    void set(std::size_t i, const AABB &box)
+    {
+        minX[i] = box.minX;
+        minY[i] = box.minY;
+        maxX[i] = box.maxX;
+        maxY[i] = box.maxY;
+    }
+};
+
+enum class OverlapKernel
+{
+    Scalar,
+    SSE2, // 4 candidatos por vez
+    AVX2  // 8 candidatos por vez
+};
+
+// Escolhido na primeira chamada: SSE2 se houver (o AVX2 mediu mais lento
+// no overlap_bench), senão escalar.
+OverlapKernel ActiveOverlapKernel();
+bool OverlapKernelSupported(OverlapKernel kernel);
+// Força um kernel (benchmark); false se a CPU não suporta.
+bool SetOverlapKernel(OverlapKernel kernel);
+const char *OverlapKernelName(OverlapKernel kernel);
+
+// Overlaps(box, bounds[i]) para i em [begin, end): escreve os i que
+// encostam em out (em ordem crescente) e devolve quantos. out precisa de
+// espaço para end - begin índices.
+int OverlapBatch(const AABB &box, const BoundsSoA &bounds, int begin, int end, int *out);
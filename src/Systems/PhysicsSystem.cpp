@@ -1,38 +1,45 @@
 #include "PhysicsSystem.h"
-#include "../Engine/Engine.h"
+#include "../Engine/ThreadPool.h"
 #include "../World/Scene.h"
-#include "../World/Entity.h"
 #include "../World/IScene.h"
+#include "../World/View.h"
+#include "../Time/Stopwatch.h"
 #include <algorithm>
+#include <atomic>
 #include <cmath>
-#include <unordered_map>
+#include <numeric>
+#include <utility>
 #include <vector>
 
-struct AABB
-{
-    float minX;
-    float minY;
-    float maxX;
-    float maxY;
-};
-
+// Ponteiros para as colunas do archetype; válidos durante o step. A física
+// trabalha no world; o mesmo deslocamento vai para o local (filhos inclusive,
+// já que world = world do pai + local).
 struct ColliderEntry
 {
-    Entity *entity = nullptr;
+    EntityId id = InvalidEntity;
+    Transform *transform = nullptr;
+    WorldTransform *world = nullptr;
+    std::uint32_t *transformTick = nullptr;
+    std::uint32_t *worldTick = nullptr;
+    const ColliderAABB *collider = nullptr;
+    RigidBody2D *body = nullptr; // o CCD zera a velocidade contra a face
     AABB bounds{};
+    std::uint32_t layerMask = 0; // cópia: consultas não seguem os ponteiros
+    bool refit = false; // bounds recalculado neste step
+    bool sleeping = false; // dormindo: vai com os estáticos, peso 0 no solver
 };
 
-static AABB BuildAABB(const Entity &e)
+static AABB BuildAABB(const WorldTransform &t, const ColliderAABB &c)
 {
-    float x = e.transform.x + e.collider.offsetX;
-    float y = e.transform.y + e.collider.offsetY;
-    return {x, y, x + e.collider.w, y + e.collider.h};
+    float x = t.x + c.offsetX;
+    float y = t.y + c.offsetY;
+    return {x, y, x + c.w, y + c.h};
 }
 
-std::uint64_t PhysicsSystem::pairKey(int a, int b) const
+std::uint64_t PhysicsSystem::pairKey(std::uint32_t a, std::uint32_t b) const
 {
-    std::uint32_t minId = (a < b) ? (std::uint32_t)a : (std::uint32_t)b;
-    std::uint32_t maxId = (a < b) ? (std::uint32_t)b : (std::uint32_t)a;
+    std::uint32_t minId = (a < b) ? a : b;
+    std::uint32_t maxId = (a < b) ? b : a;
     return (static_cast<std::uint64_t>(minId) << 32) | maxId;
 }
 
@@ -46,215 +53,1897 @@ static float OverlapAmount(float amin, float amax, float bmin, float bmax)
     return std::min(amax, bmax) - std::max(amin, bmin);
 }
 
-void PhysicsSystem::resolve(Engine &engine, Scene &scene, int idA, int idB)
+static void Move(ColliderEntry &e, float dx, float dy, std::uint32_t tick)
 {
-    (void)engine;
-    Entity *a = scene.findEntity(idA);
-    Entity *b = scene.findEntity(idB);
-    if (!a || !b)
+    if (dx == 0.0f && dy == 0.0f)
         return;
+    e.transform->x += dx;
+    e.transform->y += dy;
+    e.world->x += dx;
+    e.world->y += dy;
+    *e.transformTick = tick;
+    *e.worldTick = tick;
+}
 
-    if (a->collider.isTrigger || b->collider.isTrigger)
-        return;
+// Testes exatos dos candidatos (pairs_ ordenado). Com muitos pares a lista
+// é cortada em blocos contíguos, um job por bloco, cada um com seu buffer;
+// juntar os blocos em ordem devolve a mesma lista ordenada que o loop
+// serial produziria. Só lê bounds: nada é movido aqui.
+void PhysicsSystem::testPairs(ThreadPool &pool)
+{
+    const int parallelPairs = 2048; // abaixo disso o submit custa mais que o teste
+    const int minBlockPairs = 512;
+    int count = (int)pairs_.size();
+    int blocks = 1;
+    if (count >= parallelPairs)
+        blocks = std::max(1, std::min(pool.threadCount() + 1, count / minBlockPairs));
+    if ((int)pairBlocks_.size() < blocks)
+        pairBlocks_.resize(blocks);
+    stats_.pairBlocks = blocks;
+
+    auto run = [this, count, blocks](int b)
+    {
+        PairBlock &block = pairBlocks_[b];
+        block.contacts.clear();
+        block.tested = 0;
+        int begin = (int)((long long)count * b / blocks);
+        int end = (int)((long long)count * (b + 1) / blocks);
+        for (int k = begin; k < end; ++k)
+        {
+            std::uint64_t pair = pairs_[k];
+            const ColliderEntry &a = colliders_[(int)(pair >> 32)];
+            const ColliderEntry &c = colliders_[(int)(pair & 0xFFFFFFFFu)];
+            if (a.id == c.id || (a.collider->layerMask & c.collider->layerMask) == 0)
+                continue;
+            block.tested++;
+            if (Intersects(a.bounds, c.bounds))
+                block.contacts.push_back(pair);
+        }
+    };
+
+    if (blocks == 1)
+        run(0);
+    else
+    {
+        std::atomic<int> remaining(blocks - 1);
+        for (int b = 1; b < blocks; ++b)
+            pool.submit([&run, b]()
+                        { run(b); },
+                        &remaining);
+        run(0);
+        pool.wait(remaining);
+    }
 
-    bool aKinematic = a->rigidbody.enabled && a->rigidbody.isKinematic;
-    bool bKinematic = b->rigidbody.enabled && b->rigidbody.isKinematic;
-    if (aKinematic && bKinematic)
+    contacts_.clear();
+    for (int b = 0; b < blocks; ++b)
+    {
+        stats_.pairsTested += pairBlocks_[b].tested;
+        contacts_.insert(contacts_.end(), pairBlocks_[b].contacts.begin(), pairBlocks_[b].contacts.end());
+    }
+}
+
+// ---- Consultas --------------------------------------------------------
+
+// Slab: recorta [tmin, tmax] do raio (dx, dy normalizado) à caixa fechada.
+// axis = eixo da face de entrada, se a entrada passou de tmin (-1: não).
+static bool ClipRay(const AABB &b, float ox, float oy, float dx, float dy, float &tmin, float &tmax, int &axis)
+{
+    axis = -1;
+    const float o[2] = {ox, oy};
+    const float d[2] = {dx, dy};
+    const float lo[2] = {b.minX, b.minY};
+    const float hi[2] = {b.maxX, b.maxY};
+    for (int a = 0; a < 2; ++a)
+    {
+        if (d[a] == 0.0f)
+        {
+            if (o[a] < lo[a] || o[a] > hi[a])
+                return false;
+            continue;
+        }
+        float inv = 1.0f / d[a];
+        float t1 = (lo[a] - o[a]) * inv;
+        float t2 = (hi[a] - o[a]) * inv;
+        if (t1 > t2)
+            std::swap(t1, t2);
+        if (t1 > tmin)
+        {
+            tmin = t1;
+            axis = a;
+        }
+        tmax = std::min(tmax, t2);
+        if (tmin > tmax)
+            return false;
+    }
+    return true;
+}
+
+// Raio contra caixa fechada; t = distância de entrada (0 se a origem está
+// dentro), axis = eixo da face de entrada (-1: dentro).
+static bool RayHitsBox(const AABB &b, float ox, float oy, float dx, float dy, float maxDistance, float &t, int &axis)
+{
+    float tmin = 0.0f;
+    float tmax = maxDistance;
+    if (!ClipRay(b, ox, oy, dx, dy, tmin, tmax, axis))
+        return false;
+    t = tmin;
+    return true;
+}
+
+static float DistanceSq(const AABB &b, float x, float y)
+{
+    float dx = std::max(std::max(b.minX - x, 0.0f), x - b.maxX);
+    float dy = std::max(std::max(b.minY - y, 0.0f), y - b.maxY);
+    return dx * dx + dy * dy;
+}
+
+// fn(int entry) para cada collider do snapshot cujo bounds encosta em box,
+// sem repetição. Só lê o snapshot (scratch é de quem chama).
+template <typename Fn>
+void PhysicsSystem::forEachCandidate(const AABB &box, QueryScratch &scratch, Fn &&fn) const
+{
+    if (!querySnapshot_)
         return;
+    const std::vector<ColliderEntry> &colliders = colliders_;
+    int dynamicCount = dynamicCount_;
+    auto emit = [&](int entry)
+    {
+        if (Overlaps(colliders[entry].bounds, box))
+            fn(entry);
+    };
 
-    AABB ab = BuildAABB(*a);
-    AABB bb = BuildAABB(*b);
+    staticGrid_.query(box, [&](int k)
+                      { emit(dynamicCount + k); });
 
-    float overlapX = OverlapAmount(ab.minX, ab.maxX, bb.minX, bb.maxX);
-    float overlapY = OverlapAmount(ab.minY, ab.maxY, bb.minY, bb.maxY);
-    if (overlapX <= 0.0f || overlapY <= 0.0f)
+    if (broadphase_ == Broadphase::Tree)
+    {
+        tree_.query(box, scratch.stack, [&](int proxy)
+                    {
+                        EntityId id = tree_.userData(proxy);
+                        int j = entryByIndex_[EntityIndex(id)];
+                        if (j >= 0 && j < dynamicCount && colliders[j].id == id)
+                            emit(j);
+                        return true; });
+    }
+    else if (broadphase_ == Broadphase::Sweep)
+    {
+        // só quem começa em [box.minX - maior largura, box.maxX] pode encostar
+        float from = box.minX - sapMaxWidth_;
+        auto first = std::lower_bound(sap_.begin(), sap_.end(), from,
+                                      [](const SweepProxy &p, float x)
+                                      { return p.minX < x; });
+        auto last = std::upper_bound(first, sap_.end(), box.maxX,
+                                     [](float x, const SweepProxy &p)
+                                     { return x < p.minX; });
+        int begin = (int)(first - sap_.begin());
+        int end = (int)(last - sap_.begin());
+        scratch.hits.resize(std::max(end - begin, 0));
+        int hits = OverlapBatch(box, sapBounds_, begin, end, scratch.hits.data());
+        for (int h = 0; h < hits; ++h)
+            fn(sap_[scratch.hits[h]].entry);
+    }
+    else
+    {
+        grid_.query(box, emit);
+    }
+}
+
+// Anda o segmento em trechos (AABB pequeno por trecho em vez de um enorme
+// na diagonal). first: para no primeiro trecho que já garante o mais perto.
+// O segmento é recortado antes aos bounds do snapshot: maxDistance infinito
+// ou enorme anda só o trecho em que há colliders.
+template <typename Fn>
+void PhysicsSystem::marchRay(const RayQuery &ray, float dx, float dy, bool first, Fn &&fn) const
+{
+    if (!querySnapshot_ || colliders_.empty())
+        return;
+    float begin = 0.0f;
+    float end = ray.maxDistance;
+    int axis = -1;
+    if (!ClipRay(queryBounds_, ray.originX, ray.originY, dx, dy, begin, end, axis))
         return;
 
-    float axCenter = (ab.minX + ab.maxX) * 0.5f;
-    float ayCenter = (ab.minY + ab.maxY) * 0.5f;
-    float bxCenter = (bb.minX + bb.maxX) * 0.5f;
-    float byCenter = (bb.minY + bb.maxY) * 0.5f;
+    float chunk = std::max((float)cellSize_ * 4.0f, 1.0f);
+    // contador inteiro: begin + k * chunk não empaca em distâncias grandes
+    for (int k = 0;; ++k)
+    {
+        float s0 = begin + chunk * (float)k;
+        if (s0 > end)
+            break;
+        float s1 = std::min(end, s0 + chunk);
+        float x0 = ray.originX + dx * s0;
+        float y0 = ray.originY + dy * s0;
+        float x1 = ray.originX + dx * s1;
+        float y1 = ray.originY + dy * s1;
+        AABB box{std::min(x0, x1), std::min(y0, y1), std::max(x0, x1), std::max(y0, y1)};
+        float nearest = fn(box);
+        if (first && nearest <= s1)
+            return;
+    }
+}
 
-    float moveAx = 0.0f;
-    float moveAy = 0.0f;
-    float moveBx = 0.0f;
-    float moveBy = 0.0f;
+bool PhysicsSystem::raycast(const RayQuery &ray, RaycastHit &hit, QueryScratch &scratch) const
+{
+    hit = RaycastHit{};
+    float len = std::sqrt(ray.dirX * ray.dirX + ray.dirY * ray.dirY);
+    if (len == 0.0f || !(ray.maxDistance > 0.0f))
+        return false;
+    float dx = ray.dirX / len;
+    float dy = ray.dirY / len;
+
+    float best = ray.maxDistance;
+    int bestEntry = -1;
+    int bestAxis = -1;
+    marchRay(ray, dx, dy, true, [&](const AABB &box)
+             {
+                 forEachCandidate(box, scratch, [&](int entry)
+                                  {
+                                      const ColliderEntry &e = colliders_[entry];
+                                      if ((e.layerMask & ray.layerMask) == 0)
+                                          return;
+                                      float t = 0.0f;
+                                      int axis = -1;
+                                      if (!RayHitsBox(e.bounds, ray.originX, ray.originY, dx, dy, ray.maxDistance, t, axis))
+                                          return;
+                                      // empate: menor posição, igual em qualquer broadphase
+                                      if (t < best || (t == best && (bestEntry < 0 || entry < bestEntry)))
+                                      {
+                                          best = t;
+                                          bestEntry = entry;
+                                          bestAxis = axis;
+                                      }
+                                  });
+                 return bestEntry >= 0 ? best : ray.maxDistance + 1.0f; });
+
+    if (bestEntry < 0)
+        return false;
+    hit.id = colliders_[bestEntry].id;
+    hit.distance = best;
+    hit.x = ray.originX + dx * best;
+    hit.y = ray.originY + dy * best;
+    if (bestAxis == 0)
+        hit.normalX = dx > 0.0f ? -1.0f : 1.0f;
+    else if (bestAxis == 1)
+        hit.normalY = dy > 0.0f ? -1.0f : 1.0f;
+    return true;
+}
+
+bool PhysicsSystem::raycast(const RayQuery &ray, RaycastHit &hit) const
+{
+    return raycast(ray, hit, scratch_);
+}
+
+int PhysicsSystem::raycastAll(const RayQuery &ray, std::vector<RaycastHit> &out) const
+{
+    out.clear();
+    float len = std::sqrt(ray.dirX * ray.dirX + ray.dirY * ray.dirY);
+    if (len == 0.0f || !(ray.maxDistance > 0.0f))
+        return 0;
+    float dx = ray.dirX / len;
+    float dy = ray.dirY / len;
+
+    marchRay(ray, dx, dy, false, [&](const AABB &box)
+             {
+                 forEachCandidate(box, scratch_, [&](int entry)
+                                  {
+                                      const ColliderEntry &e = colliders_[entry];
+                                      if ((e.layerMask & ray.layerMask) == 0)
+                                          return;
+                                      float t = 0.0f;
+                                      int axis = -1;
+                                      if (!RayHitsBox(e.bounds, ray.originX, ray.originY, dx, dy, ray.maxDistance, t, axis))
+                                          return;
+                                      RaycastHit hit;
+                                      hit.id = e.id;
+                                      hit.distance = t;
+                                      hit.x = ray.originX + dx * t;
+                                      hit.y = ray.originY + dy * t;
+                                      if (axis == 0)
+                                          hit.normalX = dx > 0.0f ? -1.0f : 1.0f;
+                                      else if (axis == 1)
+                                          hit.normalY = dy > 0.0f ? -1.0f : 1.0f;
+                                      out.push_back(hit);
+                                  });
+                 return ray.maxDistance; });
+
+    // a mesma caixa pode aparecer em vários trechos (mesmo t)
+    auto byDistance = [](const RaycastHit &a, const RaycastHit &b)
+    { return a.distance < b.distance || (a.distance == b.distance && a.id < b.id); };
+    std::sort(out.begin(), out.end(), byDistance);
+    out.erase(std::unique(out.begin(), out.end(), [](const RaycastHit &a, const RaycastHit &b)
+                          { return a.id == b.id; }),
+              out.end());
+    return (int)out.size();
+}
+
+void PhysicsSystem::raycastBatch(const RayQuery *rays, int count, RaycastHit *hits, ThreadPool *pool) const
+{
+    const int minBlockRays = 64;
+    int blocks = 1;
+    if (pool && count >= minBlockRays * 2)
+        blocks = std::min(pool->threadCount() + 1, count / minBlockRays);
+    if ((int)batchScratch_.size() < blocks)
+        batchScratch_.resize(blocks);
+
+    // cada raio escreve só em hits[i]: o resultado não depende dos blocos
+    auto run = [this, rays, hits, count, blocks](int b)
+    {
+        int begin = (int)((long long)count * b / blocks);
+        int end = (int)((long long)count * (b + 1) / blocks);
+        for (int i = begin; i < end; ++i)
+            raycast(rays[i], hits[i], batchScratch_[b]);
+    };
+
+    if (blocks == 1)
+        run(0);
+    else
+    {
+        std::atomic<int> remaining(blocks - 1);
+        for (int b = 1; b < blocks; ++b)
+            pool->submit([&run, b]()
+                         { run(b); },
+                         &remaining);
+        run(0);
+        pool->wait(remaining);
+    }
+}
+
+int PhysicsSystem::overlapBox(const AABB &box, std::vector<EntityId> &out, std::uint32_t layerMask) const
+{
+    out.clear();
+    forEachCandidate(box, scratch_, [&](int entry)
+                     {
+                         if (colliders_[entry].layerMask & layerMask)
+                             out.push_back(colliders_[entry].id); });
+    std::sort(out.begin(), out.end());
+    return (int)out.size();
+}
+
+int PhysicsSystem::overlapPoint(float x, float y, std::vector<EntityId> &out, std::uint32_t layerMask) const
+{
+    return overlapBox(AABB{x, y, x, y}, out, layerMask);
+}
+
+void PhysicsSystem::overlapBoxBatch(const AABB *boxes, int count, std::vector<EntityId> &out,
+                                    std::vector<int> &offsets, std::uint32_t layerMask) const
+{
+    out.clear();
+    offsets.assign(1, 0);
+    for (int i = 0; i < count; ++i)
+    {
+        std::size_t begin = out.size();
+        forEachCandidate(boxes[i], scratch_, [&](int entry)
+                         {
+                             if (colliders_[entry].layerMask & layerMask)
+                                 out.push_back(colliders_[entry].id); });
+        std::sort(out.begin() + begin, out.end());
+        offsets.push_back((int)out.size());
+    }
+}
+
+int PhysicsSystem::nearest(float x, float y, int k, std::vector<EntityId> &out,
+                           std::uint32_t layerMask, float maxDistance) const
+{
+    out.clear();
+    if (k <= 0 || !querySnapshot_ || colliders_.empty())
+        return 0;
+
+    // tudo no snapshot: limite para parar de crescer a caixa
+    const AABB &world = queryBounds_;
+
+    struct Found
+    {
+        float distSq;
+        EntityId id;
+    };
+    std::vector<Found> found;
+    float maxSq = maxDistance * maxDistance;
+    float radius = std::min((float)cellSize_, maxDistance);
+    for (;;)
+    {
+        found.clear();
+        forEachCandidate(AABB{x - radius, y - radius, x + radius, y + radius}, scratch_, [&](int entry)
+                         {
+                             const ColliderEntry &e = colliders_[entry];
+                             if ((e.layerMask & layerMask) == 0)
+                                 return;
+                             float d = DistanceSq(e.bounds, x, y);
+                             if (d <= maxSq)
+                                 found.push_back(Found{d, e.id}); });
+        std::sort(found.begin(), found.end(), [](const Found &a, const Found &b)
+                  { return a.distSq < b.distSq || (a.distSq == b.distSq && a.id < b.id); });
+
+        // quem está a <= radius encosta na caixa: os k primeiros já são finais
+        bool enough = (int)found.size() >= k && found[k - 1].distSq <= radius * radius;
+        bool coversAll = Contains(AABB{x - radius, y - radius, x + radius, y + radius}, world);
+        if (enough || coversAll || radius >= maxDistance)
+            break;
+        radius = std::min(radius * 2.0f, maxDistance);
+    }
+
+    int count = std::min(k, (int)found.size());
+    for (int i = 0; i < count; ++i)
+        out.push_back(found[i].id);
+    return count;
+}
+
+// Tempo de impacto (0..1) de a andando (dx, dy) contra b parado; axis = 0
+// se bate pela face x, 1 pela face y. false se não bate no intervalo ou se
+// já começa sobreposto (aí o resolve discreto cuida).
+static bool SweptHit(const AABB &a, float dx, float dy, const AABB &b, float &toi, int &axis)
+{
+    const float inf = 1e30f;
+    float enterX = -inf, exitX = inf;
+    if (dx > 0.0f)
+    {
+        enterX = (b.minX - a.maxX) / dx;
+        exitX = (b.maxX - a.minX) / dx;
+    }
+    else if (dx < 0.0f)
+    {
+        enterX = (b.maxX - a.minX) / dx;
+        exitX = (b.minX - a.maxX) / dx;
+    }
+    else if (a.maxX <= b.minX || a.minX >= b.maxX)
+        return false;
+
+    float enterY = -inf, exitY = inf;
+    if (dy > 0.0f)
+    {
+        enterY = (b.minY - a.maxY) / dy;
+        exitY = (b.maxY - a.minY) / dy;
+    }
+    else if (dy < 0.0f)
+    {
+        enterY = (b.maxY - a.minY) / dy;
+        exitY = (b.minY - a.maxY) / dy;
+    }
+    else if (a.maxY <= b.minY || a.minY >= b.maxY)
+        return false;
+
+    float enter = std::max(enterX, enterY);
+    float exit = std::min(exitX, exitY);
+    if (enter >= exit || enter < 0.0f || enter >= 1.0f)
+        return false;
+    toi = enter;
+    axis = enterX > enterY ? 0 : 1;
+    return true;
+}
+
+static AABB Offset(const AABB &a, float dx, float dy)
+{
+    return {a.minX + dx, a.minY + dy, a.maxX + dx, a.maxY + dy};
+}
+
+// Empurra a para fora de uma caixa fixa (tile), pelo eixo de menor
+// sobreposição. false se não havia sobreposição.
+bool PhysicsSystem::resolveTile(ColliderEntry &a, const AABB &box)
+{
+    AABB ab = BuildAABB(*a.world, *a.collider);
+    float overlapX = OverlapAmount(ab.minX, ab.maxX, box.minX, box.maxX);
+    float overlapY = OverlapAmount(ab.minY, ab.maxY, box.minY, box.maxY);
+    if (overlapX <= 0.0f || overlapY <= 0.0f)
+        return false;
 
     if (overlapX < overlapY)
     {
-        float dir = (axCenter < bxCenter) ? -1.0f : 1.0f;
-        if (aKinematic)
-            moveBx = -dir * overlapX;
-        else if (bKinematic)
-            moveAx = dir * overlapX;
-        else
+        float dir = (ab.minX + ab.maxX < box.minX + box.maxX) ? -1.0f : 1.0f;
+        Move(a, dir * overlapX, 0.0f, stepTick_);
+    }
+    else
+    {
+        float dir = (ab.minY + ab.maxY < box.minY + box.maxY) ? -1.0f : 1.0f;
+        Move(a, 0.0f, dir * overlapY, stepTick_);
+    }
+    return true;
+}
+
+// Monta colliders_ ([dinâmicos | estáticos]) e a grade estática. Refit só
+// de quem mudou desde since; o resto reusa o cache.
+// simulate = false (refreshQueries): só refaz bounds e listas; não acorda
+// ninguém nem mexe no estado de sono. Quem acordaria fica com os dinâmicos.
+void PhysicsSystem::collectColliders(Scene &scene, std::uint32_t since, bool simulate)
+{
+    std::vector<ColliderEntry> &colliders = colliders_;
+    std::vector<ColliderEntry> &statics = statics_;
+    colliders.clear();
+    statics.clear();
+    colliders.reserve(scene.entityCount());
+
+    View<Transform, WorldTransform, const ColliderAABB>(scene).eachChunk(
+        [&](Archetype &arch, int c, int count, const EntityId *ids,
+            Transform *transforms, WorldTransform *worlds, const ColliderAABB *cols)
         {
-            moveAx = dir * (overlapX * 0.5f);
-            moveBx = -dir * (overlapX * 0.5f);
+            RigidBody2D *bodies = arch.has(ComponentRigidBody) ? arch.rigidbodies.chunk(c) : nullptr;
+            std::uint32_t *transformTicks = arch.ticks<Transform>().chunk(c);
+            std::uint32_t *worldTicks = arch.ticks<WorldTransform>().chunk(c);
+            const std::uint32_t *colliderTicks = arch.ticks<ColliderAABB>().chunk(c);
+            int colStep = arch.step<ColliderAABB>(); // 0: forma compartilhada (prefab)
+            for (int i = 0; i < count; ++i)
+            {
+                ColliderEntry entry;
+                entry.id = ids[i];
+                entry.transform = &transforms[i];
+                entry.world = &worlds[i];
+                entry.transformTick = &transformTicks[i];
+                entry.worldTick = &worldTicks[i];
+                entry.collider = &cols[i * colStep];
+                entry.body = bodies ? &bodies[i] : nullptr;
+                entry.layerMask = entry.collider->layerMask;
+
+                std::uint32_t index = EntityIndex(ids[i]);
+                if (index >= boundsCache_.size())
+                    boundsCache_.resize(index + 1);
+                if (worldTicks[i] > since || colliderTicks[i] > since)
+                {
+                    boundsCache_[index] = BuildAABB(worlds[i], *entry.collider);
+                    entry.refit = true;
+                    stats_.collidersRefit++;
+                }
+                else
+                {
+                    stats_.collidersSkipped++;
+                }
+                entry.bounds = boundsCache_[index];
+                if (!(entry.body && entry.body->isKinematic) && index < sleep_.size())
+                {
+                    // acorda se o jogo mexeu na forma ou na posição
+                    SleepState &s = sleep_[index];
+                    if (s.id == ids[i] && s.asleep)
+                    {
+                        if (colliderTicks[i] >= s.sleepTick || worlds[i].x != s.x || worlds[i].y != s.y)
+                        {
+                            if (simulate)
+                                wake(s);
+                        }
+                        else
+                        {
+                            entry.sleeping = true;
+                            if (simulate)
+                                s.seen = stepTick_;
+                        }
+                    }
+                }
+                // kinematic: nem integra nem é empurrado pelo solver (sem
+                // corpo ainda é empurrado, então fica com os dinâmicos).
+                // Dormindo fica com eles até acordar.
+                if ((entry.body && entry.body->isKinematic) || entry.sleeping)
+                    statics.push_back(entry);
+                else
+                    colliders.push_back(entry);
+            }
+        });
+
+    // colliders = [dinâmicos | estáticos]
+    dynamicCount_ = (int)colliders.size();
+    colliders.insert(colliders.end(), statics.begin(), statics.end());
+    stats_.colliders = (int)colliders.size();
+    stats_.staticColliders = (int)statics.size();
+    updateStatic(colliders, dynamicCount_);
+    if (simulate)
+        wakeIslands();
+}
+
+// Atualiza a estrutura da broadphase ativa com os bounds de colliders_
+// (só dinâmicos; os estáticos estão na staticGrid_).
+void PhysicsSystem::updateBroadphase(std::uint32_t structureVersion, float fixedDt)
+{
+    std::vector<ColliderEntry> &colliders = colliders_;
+    if (broadphase_ == Broadphase::Tree)
+    {
+        updateTree(colliders, dynamicCount_, structureVersion, fixedDt);
+        stats_.treeDepth = tree_.height();
+    }
+    else if (broadphase_ == Broadphase::Sweep)
+    {
+        updateSweep(colliders, dynamicCount_);
+
+        // bounds na ordem de sap_, em SoA para o teste em lote
+        int count = (int)sap_.size();
+        sapBounds_.resize(count);
+        sapHits_.resize(count);
+        sapMaxWidth_ = 0.0f;
+        for (int k = 0; k < count; ++k)
+        {
+            const AABB &b = colliders[sap_[k].entry].bounds;
+            sapBounds_.set(k, b);
+            sapMaxWidth_ = std::max(sapMaxWidth_, b.maxX - b.minX);
         }
     }
     else
     {
-        float dir = (ayCenter < byCenter) ? -1.0f : 1.0f;
-        if (aKinematic)
-            moveBy = -dir * overlapY;
-        else if (bKinematic)
-            moveAy = dir * overlapY;
-        else
+        grid_.clear((float)cellSize_);
+        for (int i = 0; i < dynamicCount_; ++i)
+            grid_.insert(i, colliders[i].bounds);
+        grid_.finalize();
+    }
+
+    if (!colliders.empty())
+    {
+        queryBounds_ = colliders[0].bounds;
+        for (const ColliderEntry &e : colliders)
+            queryBounds_ = Union(queryBounds_, e.bounds);
+    }
+    querySnapshot_ = true;
+}
+
+// pairs_ = candidatos (posições em colliders_, a < b), ordenados e sem
+// repetição: a ordem não depende da broadphase.
+void PhysicsSystem::gatherPairs()
+{
+    const std::vector<ColliderEntry> &colliders = colliders_;
+    int dynamicCount = dynamicCount_;
+    std::vector<std::uint64_t> &pairs = pairs_;
+    pairs.clear();
+    auto candidate = [&](int a, int b)
+    {
+        if (a > b)
+            std::swap(a, b);
+        pairs.push_back(((std::uint64_t)(std::uint32_t)a << 32) | (std::uint32_t)b);
+    };
+
+    if (broadphase_ == Broadphase::Tree)
+    {
+        // cada par sai uma vez: só o lado de menor posição consulta
+        for (int i = 0; i < dynamicCount; ++i)
+        {
+            tree_.query(colliders[i].bounds, [&](int proxy)
+                        {
+                            int j = entryByIndex_[EntityIndex(tree_.userData(proxy))];
+                            if (j > i)
+                                candidate(i, j);
+                            return true; });
+        }
+    }
+    else if (broadphase_ == Broadphase::Sweep)
+    {
+        // janela ordenada em x, testada de uma vez (x e y)
+        int count = (int)sap_.size();
+        for (int i = 0; i < count; ++i)
         {
-            moveAy = dir * (overlapY * 0.5f);
-            moveBy = -dir * (overlapY * 0.5f);
+            const SweepProxy &p = sap_[i];
+            int end = i + 1;
+            while (end < count && sap_[end].minX <= p.maxX)
+                end++;
+            int hits = OverlapBatch(colliders[p.entry].bounds, sapBounds_, i + 1, end, sapHits_.data());
+            for (int h = 0; h < hits; ++h)
+                candidate(p.entry, sap_[sapHits_[h]].entry);
         }
     }
+    else
+    {
+        grid_.forEachPair(candidate);
+    }
+
+    // Dinâmico x estático; estático x estático nunca é testado
+    for (int i = 0; i < dynamicCount; ++i)
+    {
+        staticGrid_.query(colliders[i].bounds, [&](int k)
+                          { candidate(i, dynamicCount + k); });
+    }
+
+    std::sort(pairs.begin(), pairs.end());
+    pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+}
 
-    a->transform.x += moveAx;
-    a->transform.y += moveAy;
-    b->transform.x += moveBx;
-    b->transform.y += moveBy;
+// Sem escrita desde o snapshot não há o que refazer. O tick do último step
+// não avança: o próximo step ainda vê (e refaz) o que mudou aqui.
+void PhysicsSystem::refreshQueries(Scene &scene)
+{
+    if (querySnapshot_ && scene.writeVersion() == queryWriteVersion_)
+        return;
+    PhysicsStats saved = stats_;
+    collectColliders(scene, lastStepTick_, false);
+    updateBroadphase(scene.structureVersion(), 0.0f);
+    queryWriteVersion_ = scene.writeVersion();
+    stats_ = saved;
 }
 
-void PhysicsSystem::step(Engine &engine, Scene &scene, float fixedDt, IScene *callbacks)
+void PhysicsSystem::step(ThreadPool &workers, Scene &scene, float fixedDt)
 {
+    Stopwatch timer;
     stats_ = PhysicsStats{};
 
-    // Integrate velocities
-    for (auto &e : scene.entities())
+    // Tudo escrito depois do último step tem tick > since
+    std::uint32_t since = lastStepTick_;
+    lastStepTick_ = scene.advanceChangeTick();
+    stepTick_ = scene.changeTick();
+
+    // Tilemap mudou: qualquer um pode ter perdido o chão
+    bool tilesChanged = updateTileColliders(scene.tilemaps());
+    if (tilesChanged || !sleepEnabled_)
     {
-        if (!e.rigidbody.enabled || e.rigidbody.isKinematic)
-            continue;
-        e.transform.x += e.rigidbody.vx * fixedDt;
-        e.transform.y += e.rigidbody.vy * fixedDt;
+        for (SleepState &s : sleep_)
+            s.asleep = false;
     }
 
-    std::vector<ColliderEntry> colliders;
-    colliders.reserve(scene.entities().size());
+    // Integrate velocities (só archetypes com RigidBody2D)
+    View<Transform, WorldTransform, const RigidBody2D>(scene).eachChunk(
+        [&](Archetype &arch, int c, int count, const EntityId *ids,
+            Transform *transforms, WorldTransform *worlds, const RigidBody2D *bodies)
+        {
+            std::uint32_t *ticks = arch.ticks<Transform>().chunk(c);
+            std::uint32_t *worldTicks = arch.ticks<WorldTransform>().chunk(c);
+            const std::uint32_t *bodyTicks = arch.ticks<RigidBody2D>().chunk(c);
+            for (int i = 0; i < count; ++i)
+            {
+                const RigidBody2D &body = bodies[i];
+                std::uint32_t index = EntityIndex(ids[i]);
+                if (index >= interp_.size())
+                    interp_.resize(index + 1);
+                BodyInterp &from = interp_[index];
+                // dinâmico movido fora do step (teleporte) não deixa rastro;
+                // kinematic é movido pelo jogo no fixed update e interpola
+                if (from.id != ids[i] || (!body.isKinematic && (worlds[i].x != from.x || worlds[i].y != from.y)))
+                {
+                    from.id = ids[i];
+                    from.x = worlds[i].x;
+                    from.y = worlds[i].y;
+                }
+                from.prevX = from.x;
+                from.prevY = from.y;
+                if (body.isKinematic)
+                    continue;
+                if (index < sleep_.size() && sleep_[index].id == ids[i] && sleep_[index].asleep)
+                {
+                    // velocidade escrita depois de dormir acorda a ilha
+                    SleepState &s = sleep_[index];
+                    if (bodyTicks[i] < s.sleepTick && worlds[i].x == s.x && worlds[i].y == s.y)
+                        continue;
+                    wake(s);
+                }
+                stats_.bodiesIntegrated++;
+                if (body.vx == 0.0f && body.vy == 0.0f)
+                    continue;
+                float dx = body.vx * fixedDt;
+                float dy = body.vy * fixedDt;
+                transforms[i].x += dx;
+                transforms[i].y += dy;
+                worlds[i].x += dx;
+                worlds[i].y += dy;
+                ticks[i] = stepTick_;
+                worldTicks[i] = stepTick_;
+            }
+        });
+
+    collectColliders(scene, since, true);
+    std::vector<ColliderEntry> &colliders = colliders_;
+    int dynamicCount = dynamicCount_;
+    if (continuous_)
+        sweepFastBodies(colliders, dynamicCount, fixedDt);
+    updateBroadphase(scene.structureVersion(), fixedDt);
+    gatherPairs();
+
+    std::vector<PairCache> &newPairs = nextPairs_;
+    newPairs.clear();
+    events_.clear();
+    solverContacts_.clear();
 
-    for (auto &e : scene.entities())
+    // Contato confirmado pelo testPairs: evento (a = menor id) + contato
+    // para o solver
+    auto contact = [&](int ia, int ib)
     {
-        if (!e.collider.enabled)
+        stats_.collisions++;
+        const ColliderEntry &a = colliders[ia];
+        const ColliderEntry &b = colliders[ib];
+        const ColliderEntry &first = a.id < b.id ? a : b;
+        const ColliderEntry &second = a.id < b.id ? b : a;
+        std::uint64_t key = pairKey(first.id, second.id);
+        PairCache cache;
+        cache.key = key;
+        cache.layers = ((std::uint64_t)first.layerMask << 32) | second.layerMask;
+        newPairs.push_back(cache);
+
+        ContactEvent e;
+        e.a = first.id;
+        e.b = second.id;
+        e.layerA = first.layerMask;
+        e.layerB = second.layerMask;
+        e.type = findPair(key) ? ContactEventType::Stay : ContactEventType::Enter;
+        e.trigger = first.collider->isTrigger || second.collider->isTrigger;
+        const AABB &fb = first.bounds;
+        const AABB &sb = second.bounds;
+        float overlapX = OverlapAmount(fb.minX, fb.maxX, sb.minX, sb.maxX);
+        float overlapY = OverlapAmount(fb.minY, fb.maxY, sb.minY, sb.maxY);
+        if (overlapX < overlapY)
+        {
+            e.normalX = (fb.minX + fb.maxX < sb.minX + sb.maxX) ? 1.0f : -1.0f;
+            e.depth = overlapX;
+        }
+        else
+        {
+            e.normalY = (fb.minY + fb.maxY < sb.minY + sb.maxY) ? 1.0f : -1.0f;
+            e.depth = overlapY;
+        }
+        events_.push_back(e);
+
+        addSolverContact(ia, ib, (int)newPairs.size() - 1);
+    };
+
+    testPairs(workers);
+    wakeTouched();
+    for (std::uint64_t pair : contacts_)
+        contact((int)(pair >> 32), (int)(pair & 0xFFFFFFFFu));
+    solveContacts();
+
+    // Tiles por último: parede ganha de empurrão entre corpos
+    collideTiles(colliders, dynamicCount, tilesChanged);
+    updateSleep(fixedDt);
+
+    // Exits: prevPairs_ está ordenado por chave, então já saem em ordem de
+    // ids. Par com alguém dormindo não é testado, mas continua ativo até ele
+    // acordar.
+    auto byKey = [](const PairCache &x, const PairCache &y)
+    { return x.key < y.key; };
+    std::sort(newPairs.begin(), newPairs.end(), byKey);
+    std::size_t found = newPairs.size();
+    for (const PairCache &pair : prevPairs_)
+    {
+        PairCache probe;
+        probe.key = pair.key;
+        if (std::binary_search(newPairs.begin(), newPairs.begin() + found, probe, byKey))
             continue;
-        ColliderEntry entry;
-        entry.entity = &e;
-        entry.bounds = BuildAABB(e);
-        colliders.push_back(entry);
+        ContactEvent e;
+        e.a = (EntityId)(pair.key >> 32);
+        e.b = (EntityId)(pair.key & 0xFFFFFFFFu);
+        if (isSleeping(e.a) || isSleeping(e.b))
+        {
+            newPairs.push_back(pair);
+            continue;
+        }
+        e.layerA = (std::uint32_t)(pair.layers >> 32);
+        e.layerB = (std::uint32_t)(pair.layers & 0xFFFFFFFFu);
+        e.type = ContactEventType::Exit;
+        events_.push_back(e);
     }
+    if (newPairs.size() != found)
+        std::sort(newPairs.begin(), newPairs.end(), byKey);
+
+    prevPairs_.swap(newPairs);
+    stats_.activePairs = (int)prevPairs_.size();
 
-    std::unordered_map<std::int64_t, std::vector<int>> grid;
-    grid.reserve(colliders.size() * 2);
+    View<const WorldTransform, const RigidBody2D>(scene).eachChunk(
+        [&](const Archetype &, int, int count, const EntityId *ids,
+            const WorldTransform *worlds, const RigidBody2D *)
+        {
+            for (int i = 0; i < count; ++i)
+            {
+                BodyInterp &to = interp_[EntityIndex(ids[i])];
+                to.x = worlds[i].x;
+                to.y = worlds[i].y;
+            }
+        });
+    queryWriteVersion_ = scene.writeVersion();
+    stats_.stepMs = timer.elapsedMs();
+}
 
-    float invCell = 1.0f / (float)cellSize_;
-    for (int i = 0; i < (int)colliders.size(); ++i)
+// Menor tempo de impacto de a andando (dx, dy) contra estáticos e tiles.
+bool PhysicsSystem::earliestHit(const ColliderEntry &e, int dynamicCount, const AABB &a,
+                                float dx, float dy, float &toi, int &axis)
+{
+    std::vector<ColliderEntry> &colliders = colliders_;
+    AABB swept = Union(a, Offset(a, dx, dy));
+    bool hit = false;
+    toi = 1.0f;
+    auto test = [&](const AABB &b)
+    {
+        float t = 0.0f;
+        int ax = 0;
+        if (SweptHit(a, dx, dy, b, t, ax) && t < toi)
+        {
+            toi = t;
+            axis = ax;
+            hit = true;
+        }
+    };
+
+    staticGrid_.query(swept, [&](int k)
+                      {
+                          const ColliderEntry &s = colliders[dynamicCount + k];
+                          if (!s.collider->isTrigger && (s.collider->layerMask & e.collider->layerMask) != 0)
+                              test(s.bounds); });
+    for (const TileColliders &tc : tileMaps_)
+    {
+        if (tc.boxes.empty())
+            continue;
+        gatherTileBoxes(tc, swept);
+        for (int box : tileHits_)
+            test(tc.boxes[box]);
+    }
+    return hit;
+}
+
+// CCD dos corpos rápidos (andaram mais que meia caixa no step) contra
+// estáticos e tiles: volta o corpo até o tempo de impacto na face atingida,
+// zera a velocidade na normal da face (senão o próximo step varre de novo
+// contra a mesma parede) e deixa o resto do movimento deslizar no outro
+// eixo. Limite: corpo x corpo continua discreto, então dois dinâmicos
+// rápidos ainda podem se atravessar num step; o solver só vê a sobreposição
+// no fim dele.
+void PhysicsSystem::sweepFastBodies(std::vector<ColliderEntry> &colliders, int dynamicCount, float fixedDt)
+{
+    for (int i = 0; i < dynamicCount; ++i)
     {
-        const AABB &b = colliders[i].bounds;
-        int minCx = (int)std::floor(b.minX * invCell);
-        int maxCx = (int)std::floor(b.maxX * invCell);
-        int minCy = (int)std::floor(b.minY * invCell);
-        int maxCy = (int)std::floor(b.maxY * invCell);
-        for (int cy = minCy; cy <= maxCy; ++cy)
+        ColliderEntry &e = colliders[i];
+        if (!e.body || e.body->isKinematic || e.collider->isTrigger)
+            continue;
+        float dx = e.body->vx * fixedDt;
+        float dy = e.body->vy * fixedDt;
+        if (std::fabs(dx) * 2.0f <= e.collider->w && std::fabs(dy) * 2.0f <= e.collider->h)
+            continue;
+        stats_.sweptBodies++;
+
+        // integrate já moveu: parte da posição anterior
+        AABB start = Offset(e.bounds, -dx, -dy);
+        AABB at = start;
+        float restX = dx;
+        float restY = dy;
+        for (int pass = 0; pass < 2; ++pass)
         {
-            for (int cx = minCx; cx <= maxCx; ++cx)
+            float toi = 1.0f;
+            int axis = 0;
+            if (!earliestHit(e, dynamicCount, at, restX, restY, toi, axis))
+            {
+                at = Offset(at, restX, restY);
+                break;
+            }
+            stats_.sweptHits++;
+            at = Offset(at, restX * toi, restY * toi);
+            // bloqueia o eixo da face, o outro segue com o que sobrou
+            if (axis == 0)
             {
-                std::int64_t key = (static_cast<std::int64_t>(cx) << 32) ^ (std::uint32_t)cy;
-                grid[key].push_back(i);
+                restX = 0.0f;
+                restY *= 1.0f - toi;
+                e.body->vx = 0.0f;
+            }
+            else
+            {
+                restX *= 1.0f - toi;
+                restY = 0.0f;
+                e.body->vy = 0.0f;
             }
         }
+
+        float moveX = at.minX - e.bounds.minX;
+        float moveY = at.minY - e.bounds.minY;
+        if (moveX == 0.0f && moveY == 0.0f)
+            continue;
+        Move(e, moveX, moveY, stepTick_);
+        e.bounds = BuildAABB(*e.world, *e.collider);
+        e.refit = true;
+        boundsCache_[EntityIndex(e.id)] = e.bounds;
+    }
+}
+
+// Refaz a grade estática só quando o conjunto de estáticos (ou a ordem, ou
+// algum bound) mudou; na maioria dos steps não faz nada.
+void PhysicsSystem::updateStatic(const std::vector<ColliderEntry> &colliders, int dynamicCount)
+{
+    int count = (int)colliders.size() - dynamicCount;
+    bool dirty = count != (int)staticIds_.size() || staticCellSize_ != cellSize_;
+    for (int k = 0; k < count && !dirty; ++k)
+    {
+        const ColliderEntry &e = colliders[dynamicCount + k];
+        dirty = e.refit || e.id != staticIds_[k];
     }
+    if (!dirty)
+        return;
 
-    std::unordered_set<std::uint64_t> newPairs;
-    newPairs.reserve(prevPairs_.size() + 16);
+    staticIds_.resize(count);
+    staticCellSize_ = cellSize_;
+    staticGrid_.clear((float)cellSize_);
+    for (int k = 0; k < count; ++k)
+    {
+        staticIds_[k] = colliders[dynamicCount + k].id;
+        staticGrid_.insert(k, colliders[dynamicCount + k].bounds);
+    }
+    staticGrid_.finalize();
+    stats_.staticRebuilds++;
+}
 
-    for (const auto &cell : grid)
+// Funde os tiles sólidos em retângulos: corre a linha enquanto for sólido
+// e livre, depois desce enquanto a linha de baixo inteira também for.
+static void BuildTileBoxes(const Tilemap &map, std::vector<AABB> &boxes, std::vector<int> &boxOf)
+{
+    boxes.clear();
+    boxOf.assign((std::size_t)map.width * map.height, -1);
+    float size = (float)map.tileSize;
+    for (int y = 0; y < map.height; ++y)
     {
-        const std::vector<int> &items = cell.second;
-        for (size_t i = 0; i < items.size(); ++i)
+        for (int x = 0; x < map.width; ++x)
         {
-            for (size_t j = i + 1; j < items.size(); ++j)
+            if (boxOf[y * map.width + x] >= 0 || !map.solidAt(x, y))
+                continue;
+
+            int w = 1;
+            while (x + w < map.width && boxOf[y * map.width + x + w] < 0 && map.solidAt(x + w, y))
+                w++;
+            int h = 1;
+            for (; y + h < map.height; ++h)
             {
-                ColliderEntry &a = colliders[items[i]];
-                ColliderEntry &b = colliders[items[j]];
+                int k = 0;
+                while (k < w && boxOf[(y + h) * map.width + x + k] < 0 && map.solidAt(x + k, y + h))
+                    k++;
+                if (k < w)
+                    break;
+            }
 
-                int idA = a.entity->id;
-                int idB = b.entity->id;
-                if (idA == idB)
-                    continue;
+            int box = (int)boxes.size();
+            for (int dy = 0; dy < h; ++dy)
+                for (int dx = 0; dx < w; ++dx)
+                    boxOf[(y + dy) * map.width + x + dx] = box;
+            float minX = map.originX + x * size;
+            float minY = map.originY + y * size;
+            boxes.push_back(AABB{minX, minY, minX + w * size, minY + h * size});
+        }
+    }
+}
 
-                if ((a.entity->collider.layerMask & b.entity->collider.layerMask) == 0)
-                    continue;
+// Refaz as caixas dos tilemaps que mudaram (versão, tamanho, origem).
+// true se alguma foi refeita.
+bool PhysicsSystem::updateTileColliders(const std::vector<Tilemap> &maps)
+{
+    bool changed = tileMaps_.size() != maps.size();
+    tileMaps_.resize(maps.size());
+    for (std::size_t m = 0; m < maps.size(); ++m)
+    {
+        const Tilemap &map = maps[m];
+        TileColliders &tc = tileMaps_[m];
+        if (tc.version == map.version && tc.width == map.width && tc.height == map.height &&
+            tc.tileSize == map.tileSize && tc.originX == map.originX && tc.originY == map.originY)
+            continue;
+        tc.version = map.version;
+        tc.width = map.width;
+        tc.height = map.height;
+        tc.tileSize = map.tileSize;
+        tc.originX = map.originX;
+        tc.originY = map.originY;
+        if (map.width > 0 && map.height > 0 && map.tileSize > 0 && !map.solidIds.empty())
+            BuildTileBoxes(map, tc.boxes, tc.boxOf);
+        else
+        {
+            tc.boxes.clear();
+            tc.boxOf.clear();
+        }
+        changed = true;
+    }
+    return changed;
+}
 
-                stats_.pairsTested++;
-                if (!Intersects(a.bounds, b.bounds))
-                    continue;
+// tileHits_ = caixas (sem repetição, em ordem) dos tiles que box cobre.
+// Sobreposição estrita: encostar não conta.
+void PhysicsSystem::gatherTileBoxes(const TileColliders &tc, const AABB &box)
+{
+    tileHits_.clear();
+    float inv = 1.0f / (float)tc.tileSize;
+    int minTx = std::max((int)std::floor((box.minX - tc.originX) * inv), 0);
+    int minTy = std::max((int)std::floor((box.minY - tc.originY) * inv), 0);
+    int maxTx = std::min((int)std::ceil((box.maxX - tc.originX) * inv) - 1, tc.width - 1);
+    int maxTy = std::min((int)std::ceil((box.maxY - tc.originY) * inv) - 1, tc.height - 1);
+    for (int ty = minTy; ty <= maxTy; ++ty)
+    {
+        for (int tx = minTx; tx <= maxTx; ++tx)
+        {
+            int b = tc.boxOf[ty * tc.width + tx];
+            if (b >= 0)
+                tileHits_.push_back(b);
+        }
+    }
+    std::sort(tileHits_.begin(), tileHits_.end());
+    tileHits_.erase(std::unique(tileHits_.begin(), tileHits_.end()), tileHits_.end());
+}
 
-                stats_.collisions++;
-                std::uint64_t key = pairKey(idA, idB);
-                newPairs.insert(key);
+// Corpos dinâmicos contra os tiles sólidos: só as células cobertas pelo
+// AABB de cada um, sem passar pela broadphase. Corpos parados são pulados
+// (a não ser que os tiles tenham mudado).
+void PhysicsSystem::collideTiles(std::vector<ColliderEntry> &colliders, int dynamicCount, bool all)
+{
+    for (int i = 0; i < dynamicCount; ++i)
+    {
+        ColliderEntry &e = colliders[i];
+        if (!e.body || e.body->isKinematic || e.collider->isTrigger)
+            continue;
+        if (!all && !e.refit && *e.worldTick != stepTick_)
+            continue;
 
-                if (prevPairs_.find(key) == prevPairs_.end())
-                {
-                    if (callbacks)
-                        callbacks->onCollisionEnter(engine, idA, idB);
-                }
-                else
-                {
-                    if (callbacks)
-                        callbacks->onCollisionStay(engine, idA, idB);
-                }
+        for (const TileColliders &tc : tileMaps_)
+        {
+            if (tc.boxes.empty())
+                continue;
 
-                resolve(engine, scene, idA, idB);
+            AABB ab = BuildAABB(*e.world, *e.collider);
+            gatherTileBoxes(tc, ab);
+            for (int box : tileHits_)
+            {
+                if (resolveTile(e, tc.boxes[box]))
+                    stats_.tileContacts++;
             }
         }
     }
+}
 
-    for (auto key : prevPairs_)
+void PhysicsSystem::dispatchEvents(Engine &engine, IScene *callbacks) const
+{
+    if (!callbacks)
+        return;
+    for (const ContactEvent &e : events_)
     {
-        if (newPairs.find(key) != newPairs.end())
+        switch (e.type)
+        {
+        case ContactEventType::Enter:
+            callbacks->onCollisionEnter(engine, e.a, e.b);
+            break;
+        case ContactEventType::Stay:
+            callbacks->onCollisionStay(engine, e.a, e.b);
+            break;
+        case ContactEventType::Exit:
+            callbacks->onCollisionExit(engine, e.a, e.b);
+            break;
+        }
+    }
+}
+
+// Contato para o solver. Trigger e kinematic x kinematic não entram;
+// kinematic tem peso 0 (não se mexe). O eixo vem do cache do par quando
+// ainda faz sentido (manifold estável), senão do eixo de menor sobreposição.
+void PhysicsSystem::addSolverContact(int ia, int ib, int pair)
+{
+    const ColliderEntry &a = colliders_[ia];
+    const ColliderEntry &b = colliders_[ib];
+    if (a.collider->isTrigger || b.collider->isTrigger)
+        return;
+    float wa = ((a.body && a.body->isKinematic) || a.sleeping) ? 0.0f : 1.0f;
+    float wb = ((b.body && b.body->isKinematic) || b.sleeping) ? 0.0f : 1.0f;
+    if (wa + wb == 0.0f)
+        return;
+
+    AABB ab = BuildAABB(*a.world, *a.collider);
+    AABB bb = BuildAABB(*b.world, *b.collider);
+    float overlapX = OverlapAmount(ab.minX, ab.maxX, bb.minX, bb.maxX);
+    float overlapY = OverlapAmount(ab.minY, ab.maxY, bb.minY, bb.maxY);
+
+    SolverContact c;
+    c.a = ia;
+    c.b = ib;
+    c.pair = pair;
+    c.wa = wa / (wa + wb);
+    c.wb = wb / (wa + wb);
+    c.still = (wa == 0.0f && !moved(a)) || (wb == 0.0f && !moved(b));
+    c.axis = overlapX < overlapY ? 0 : 1;
+
+    const PairCache *cached = findPair(nextPairs_[pair].key);
+    if (cached && cached->axis >= 0)
+    {
+        // troca de eixo só se o do cache ficou bem pior
+        int axis = cached->axis;
+        float along = axis == 0 ? overlapX : overlapY;
+        float other = axis == 0 ? overlapY : overlapX;
+        if (along <= other * 2.0f)
+        {
+            c.axis = axis;
+            c.accumulated = cached->accumulated * warmStart_;
+        }
+    }
+    float ca = c.axis == 0 ? ab.minX + ab.maxX : ab.minY + ab.maxY;
+    float cb = c.axis == 0 ? bb.minX + bb.maxX : bb.minY + bb.maxY;
+    c.sign = (ca < cb) ? 1.0f : -1.0f; // normal de a para b
+    solverContacts_.push_back(c);
+}
+
+// Gauss-Seidel nas posições: cada contato empurra o par só o necessário
+// para zerar a penetração no seu eixo, guardando o total (accumulated >= 0)
+// para poder desfazer excesso e para o warm start do próximo step. Trabalha
+// em arrays planos (bounds e deslocamento por collider) e só escreve no
+// transform no fim.
+void PhysicsSystem::solveContacts()
+{
+    std::vector<SolverContact> &contacts = solverContacts_;
+    stats_.solverContacts = (int)contacts.size();
+    stillPush_.assign(colliders_.size() * 2, 0.0f);
+    if (contacts.empty())
+        return;
+
+    solverBounds_.resize(colliders_.size());
+    solverMove_.resize(colliders_.size() * 2);
+    for (const SolverContact &c : contacts)
+    {
+        for (int i : {c.a, c.b})
+        {
+            solverBounds_[i] = BuildAABB(*colliders_[i].world, *colliders_[i].collider);
+            solverMove_[i * 2] = 0.0f;
+            solverMove_[i * 2 + 1] = 0.0f;
+        }
+    }
+
+    auto apply = [&](const SolverContact &c, float amount)
+    {
+        float pushA = -c.sign * amount * c.wa;
+        float pushB = c.sign * amount * c.wb;
+        AABB &ab = solverBounds_[c.a];
+        AABB &bb = solverBounds_[c.b];
+        if (c.axis == 0)
+        {
+            ab.minX += pushA;
+            ab.maxX += pushA;
+            bb.minX += pushB;
+            bb.maxX += pushB;
+        }
+        else
+        {
+            ab.minY += pushA;
+            ab.maxY += pushA;
+            bb.minY += pushB;
+            bb.maxY += pushB;
+        }
+        solverMove_[c.a * 2 + c.axis] += pushA;
+        solverMove_[c.b * 2 + c.axis] += pushB;
+    };
+
+    for (const SolverContact &c : contacts)
+    {
+        if (c.accumulated > 0.0f)
+            apply(c, c.accumulated);
+    }
+
+    for (int it = 0; it < solverIterations_; ++it)
+    {
+        float worst = 0.0f;
+        for (SolverContact &c : contacts)
+        {
+            const AABB &ab = solverBounds_[c.a];
+            const AABB &bb = solverBounds_[c.b];
+            float tangent = c.axis == 0 ? OverlapAmount(ab.minY, ab.maxY, bb.minY, bb.maxY)
+                                        : OverlapAmount(ab.minX, ab.maxX, bb.minX, bb.maxX);
+            if (tangent <= 0.0f)
+                continue; // saíram de lado: não há mais contato neste eixo
+            // penetração ao longo da normal (negativa = folga)
+            float pen = c.axis == 0 ? (c.sign > 0.0f ? ab.maxX - bb.minX : bb.maxX - ab.minX)
+                                    : (c.sign > 0.0f ? ab.maxY - bb.minY : bb.maxY - ab.minY);
+            float total = std::max(c.accumulated + pen, 0.0f);
+            float delta = total - c.accumulated;
+            if (delta == 0.0f)
+                continue;
+            c.accumulated = total;
+            apply(c, delta);
+            worst = std::max(worst, std::fabs(delta));
+        }
+        stats_.solverIterations = it + 1;
+        if (worst < 0.01f) // convergiu (centésimo de pixel)
+            break;
+    }
+
+    for (const SolverContact &c : contacts)
+    {
+        for (int i : {c.a, c.b})
+        {
+            Move(colliders_[i], solverMove_[i * 2], solverMove_[i * 2 + 1], stepTick_);
+            solverMove_[i * 2] = 0.0f; // Move uma vez por collider
+            solverMove_[i * 2 + 1] = 0.0f;
+        }
+        PairCache &cache = nextPairs_[c.pair];
+        cache.axis = (std::int8_t)c.axis;
+        cache.accumulated = c.accumulated;
+        if (c.still)
+        {
+            // acomodar contra o chão parado não conta como andar (updateSleep)
+            stillPush_[c.a * 2 + c.axis] -= c.sign * c.accumulated * c.wa;
+            stillPush_[c.b * 2 + c.axis] += c.sign * c.accumulated * c.wb;
+        }
+    }
+}
+
+bool PhysicsSystem::interpolate(EntityId id, const WorldTransform &world, float alpha, float &x, float &y) const
+{
+    std::uint32_t index = EntityIndex(id);
+    if (index >= interp_.size())
+        return false;
+    const BodyInterp &p = interp_[index];
+    if (p.id != id || world.x != p.x || world.y != p.y)
+        return false;
+    x = p.prevX + (p.x - p.prevX) * alpha;
+    y = p.prevY + (p.y - p.prevY) * alpha;
+    return true;
+}
+
+// Par ativo no fim do último step (busca binária em prevPairs_).
+const PhysicsSystem::PairCache *PhysicsSystem::findPair(std::uint64_t key) const
+{
+    auto it = std::lower_bound(prevPairs_.begin(), prevPairs_.end(), key,
+                               [](const PairCache &p, std::uint64_t k)
+                               { return p.key < k; });
+    return (it != prevPairs_.end() && it->key == key) ? &*it : nullptr;
+}
+
+void PhysicsSystem::wake(SleepState &s)
+{
+    s.asleep = false;
+    s.restTime = 0.0f;
+    wakeIslands_.push_back(s.island);
+}
+
+bool PhysicsSystem::isSleeping(EntityId id) const
+{
+    std::uint32_t index = EntityIndex(id);
+    return index < sleep_.size() && sleep_[index].id == id && sleep_[index].asleep &&
+           sleep_[index].seen == stepTick_;
+}
+
+// Acorda as ilhas pedidas por wake() (uma passada para todas) e libera os
+// colliders delas, que neste step continuam na parte estática.
+void PhysicsSystem::wakeIslands()
+{
+    if (wakeIslands_.empty())
+        return;
+    std::sort(wakeIslands_.begin(), wakeIslands_.end());
+    wakeIslands_.erase(std::unique(wakeIslands_.begin(), wakeIslands_.end()), wakeIslands_.end());
+    for (SleepState &s : sleep_)
+    {
+        if (s.asleep && std::binary_search(wakeIslands_.begin(), wakeIslands_.end(), s.island))
+        {
+            s.asleep = false;
+            s.restTime = 0.0f;
+        }
+    }
+    wakeIslands_.clear();
+
+    for (int i = dynamicCount_; i < (int)colliders_.size(); ++i)
+    {
+        ColliderEntry &e = colliders_[i];
+        if (e.sleeping && !sleep_[EntityIndex(e.id)].asleep)
+            e.sleeping = false;
+    }
+}
+
+// Andou desde o fim do último step? Compara valores, não ticks: restore
+// de snapshot carimba todo mundo e não pode mudar quem acorda.
+bool PhysicsSystem::moved(const ColliderEntry &e) const
+{
+    std::uint32_t index = EntityIndex(e.id);
+    if (index >= sleep_.size() || sleep_[index].id != e.id)
+        return true;
+    return e.world->x != sleep_[index].x || e.world->y != sleep_[index].y;
+}
+
+// Dormindo só sai da parte estática acordando: por contato novo ou com
+// alguém que andou (dinâmico ou kinematic). Trigger não acorda ninguém.
+void PhysicsSystem::wakeTouched()
+{
+    std::vector<ColliderEntry> &colliders = colliders_;
+    int dynamicCount = dynamicCount_;
+    for (std::uint64_t pair : contacts_)
+    {
+        const ColliderEntry &a = colliders[(int)(pair >> 32)];
+        const ColliderEntry &b = colliders[(int)(pair & 0xFFFFFFFFu)];
+        if (!b.sleeping || a.collider->isTrigger || b.collider->isTrigger)
             continue;
-        int idA = (int)(key >> 32);
-        int idB = (int)(key & 0xFFFFFFFFu);
-        if (callbacks)
-            callbacks->onCollisionExit(engine, idA, idB);
+        if (!findPair(pairKey(a.id, b.id)) || moved(a))
+            wake(sleep_[EntityIndex(b.id)]);
     }
 
-    prevPairs_.swap(newPairs);
-    stats_.activePairs = (int)prevPairs_.size();
+    // kinematic x estático não passa pelo testPairs
+    for (int i = dynamicCount; i < (int)colliders.size(); ++i)
+    {
+        const ColliderEntry &k = colliders[i];
+        if (k.sleeping || k.collider->isTrigger || !moved(k))
+            continue;
+        staticGrid_.query(k.bounds, [&](int s)
+                          {
+                              const ColliderEntry &e = colliders[dynamicCount + s];
+                              if (e.sleeping && !e.collider->isTrigger &&
+                                  (e.layerMask & k.layerMask) != 0 && Intersects(e.bounds, k.bounds))
+                                  wake(sleep_[EntityIndex(e.id)]); });
+    }
+    wakeIslands();
 }
 
-void PhysicsSystem::debugRender(Engine &engine, const Scene &scene)
+// Ilhas = componentes do grafo de pares sólidos (encostando) entre
+// dinâmicos acordados. Cada corpo acumula tempo parado (velocidade e deslocamento do
+// step abaixo do limiar); quando o mais inquieto da ilha passa de
+// sleepDelay_, a ilha inteira dorme com um rótulo comum para acordar junta.
+void PhysicsSystem::updateSleep(float fixedDt)
 {
-    auto &q = engine.commandBuffer();
+    int count = dynamicCount_;
+    std::vector<int> &parent = islandParent_;
+    parent.resize(count);
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&](int i)
+    {
+        while (parent[i] != i)
+        {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    };
+    // pelos candidatos, não pelos contatos: depois do solver a pilha só
+    // encosta (Intersects é aberto), mas continua sendo uma ilha
+    for (std::uint64_t pair : pairs_)
+    {
+        int a = (int)(pair >> 32);
+        int b = (int)(pair & 0xFFFFFFFFu);
+        if (b >= count)
+            continue;
+        const ColliderEntry &ea = colliders_[a];
+        const ColliderEntry &eb = colliders_[b];
+        if (ea.collider->isTrigger || eb.collider->isTrigger || (ea.layerMask & eb.layerMask) == 0 ||
+            !Overlaps(ea.bounds, eb.bounds))
+            continue;
+        parent[find(a)] = find(b);
+    }
+
+    float speedSq = sleepSpeed_ * sleepSpeed_;
+    float moveSq = speedSq * fixedDt * fixedDt;
+    islandRest_.assign(count, sleepDelay_);
+    for (int i = 0; i < count; ++i)
+    {
+        const ColliderEntry &e = colliders_[i];
+        std::uint32_t index = EntityIndex(e.id);
+        if (index >= sleep_.size())
+            sleep_.resize(index + 1);
+        SleepState &s = sleep_[index];
+        if (s.id != e.id)
+        {
+            s = SleepState{};
+            s.id = e.id;
+            s.x = e.world->x;
+            s.y = e.world->y;
+        }
+        // empurrão de kinematic/dormindo que não andou não zera o tempo:
+        // vale o menor entre o deslocamento e o deslocamento sem ele
+        float dx = e.world->x - s.x;
+        float dy = e.world->y - s.y;
+        float ox = dx - stillPush_[i * 2];
+        float oy = dy - stillPush_[i * 2 + 1];
+        float distSq = std::min(dx * dx + dy * dy, ox * ox + oy * oy);
+        float vx = e.body ? e.body->vx : 0.0f;
+        float vy = e.body ? e.body->vy : 0.0f;
+        bool rest = vx * vx + vy * vy < speedSq && distSq < moveSq;
+        s.restTime = rest ? s.restTime + fixedDt : 0.0f;
+        s.x = e.world->x;
+        s.y = e.world->y;
+        int root = find(i);
+        islandRest_[root] = std::min(islandRest_[root], s.restTime);
+    }
 
-    for (const auto &e : scene.entities())
+    islandLabel_.assign(count, 0);
+    for (int i = 0; i < count; ++i)
     {
-        if (!e.collider.enabled)
+        int root = find(i);
+        if (!sleepEnabled_ || islandRest_[root] < sleepDelay_)
             continue;
+        if (islandLabel_[root] == 0)
+            islandLabel_[root] = nextIsland_++;
+        SleepState &s = sleep_[EntityIndex(colliders_[i].id)];
+        s.asleep = true;
+        s.island = islandLabel_[root];
+        s.sleepTick = stepTick_;
+        s.seen = stepTick_;
+    }
 
-        RenderCommand cmd;
-        cmd.type = RenderCommandType::Rect;
-        cmd.layer = 100;
-        cmd.x = e.transform.x + e.collider.offsetX;
-        cmd.y = e.transform.y + e.collider.offsetY;
-        cmd.w = (int)e.collider.w;
-        cmd.h = (int)e.collider.h;
-        if (e.collider.isTrigger)
+    for (const ColliderEntry &e : colliders_)
+    {
+        if (e.body && e.body->isKinematic)
         {
-            cmd.r = 255;
-            cmd.g = 200;
-            cmd.b = 80;
-            cmd.a = 120;
+            // kinematic só guarda a posição (para moved())
+            std::uint32_t index = EntityIndex(e.id);
+            if (index >= sleep_.size())
+                sleep_.resize(index + 1);
+            SleepState &s = sleep_[index];
+            if (s.id != e.id)
+                s = SleepState{};
+            s.id = e.id;
+            s.x = e.world->x;
+            s.y = e.world->y;
+            continue;
         }
+        if (isSleeping(e.id))
+            stats_.sleepingBodies++;
         else
+            stats_.awakeBodies++;
+    }
+}
+
+// EntityIndex -> posição em colliders neste step (broadphases persistentes).
+void PhysicsSystem::mapEntries(const std::vector<ColliderEntry> &colliders)
+{
+    stepCount_++;
+    for (int i = 0; i < (int)colliders.size(); ++i)
+    {
+        std::uint32_t index = EntityIndex(colliders[i].id);
+        if (index >= entryByIndex_.size())
         {
-            cmd.r = 220;
-            cmd.g = 80;
-            cmd.b = 80;
-            cmd.a = 120;
+            entryByIndex_.resize(index + 1, -1);
+            seen_.resize(index + 1, 0);
         }
-        q.submit(cmd);
+        entryByIndex_[index] = i;
+        seen_[index] = stepCount_;
     }
 }
 
+// Sincroniza os proxies com os colliders do step: cria os novos, move os
+// que mudaram (só reinsere quem saiu da caixa gorda) e, se a estrutura da
+// cena mudou, remove os de entidades que não têm mais collider.
+void PhysicsSystem::updateTree(std::vector<ColliderEntry> &colliders, int dynamicCount, std::uint32_t structureVersion, float fixedDt)
+{
+    mapEntries(colliders);
+    if (proxies_.size() < entryByIndex_.size())
+        proxies_.resize(entryByIndex_.size(), DynamicAABBTree::Null);
+
+    // quem virou estático (ex.: isKinematic ligado) sai da árvore
+    for (int i = dynamicCount; i < (int)colliders.size(); ++i)
+    {
+        int &proxy = proxies_[EntityIndex(colliders[i].id)];
+        if (proxy != DynamicAABBTree::Null && tree_.userData(proxy) == colliders[i].id)
+        {
+            tree_.destroyProxy(proxy);
+            proxy = DynamicAABBTree::Null;
+        }
+    }
+
+    for (int i = 0; i < dynamicCount; ++i)
+    {
+        const ColliderEntry &e = colliders[i];
+        int &proxy = proxies_[EntityIndex(e.id)];
+        if (proxy != DynamicAABBTree::Null && tree_.userData(proxy) != e.id)
+        {
+            // índice reaproveitado por outra entidade
+            tree_.destroyProxy(proxy);
+            proxy = DynamicAABBTree::Null;
+        }
+        if (proxy == DynamicAABBTree::Null)
+        {
+            proxy = tree_.createProxy(e.bounds, e.id);
+            stats_.treeRefits++;
+        }
+        else if (e.refit)
+        {
+            float dx = e.body ? e.body->vx * fixedDt : 0.0f;
+            float dy = e.body ? e.body->vy * fixedDt : 0.0f;
+            if (tree_.moveProxy(proxy, e.bounds, dx, dy))
+                stats_.treeRefits++;
+        }
+    }
+
+    if (structureVersion == treeStructure_)
+        return;
+    treeStructure_ = structureVersion;
+    for (std::uint32_t index = 0; index < proxies_.size(); ++index)
+    {
+        if (proxies_[index] != DynamicAABBTree::Null && seen_[index] != stepCount_)
+        {
+            tree_.destroyProxy(proxies_[index]);
+            proxies_[index] = DynamicAABBTree::Null;
+        }
+    }
+}
+
+// Mantém sap_ ordenado por minX entre steps: tira quem sumiu, atualiza os
+// limites, acrescenta os novos e reordena por inserção (poucas trocas
+// quando os corpos andam pouco).
+void PhysicsSystem::updateSweep(const std::vector<ColliderEntry> &colliders, int dynamicCount)
+{
+    mapEntries(colliders);
+    if (sapId_.size() < entryByIndex_.size())
+        sapId_.resize(entryByIndex_.size(), InvalidEntity);
+
+    std::size_t kept = 0;
+    for (std::size_t k = 0; k < sap_.size(); ++k)
+    {
+        SweepProxy p = sap_[k];
+        std::uint32_t index = EntityIndex(p.id);
+        int entry = seen_[index] == stepCount_ ? entryByIndex_[index] : -1;
+        if (entry < 0 || entry >= dynamicCount || colliders[entry].id != p.id)
+        {
+            if (sapId_[index] == p.id)
+                sapId_[index] = InvalidEntity;
+            continue;
+        }
+        p.entry = entry;
+        p.minX = colliders[entry].bounds.minX;
+        p.maxX = colliders[entry].bounds.maxX;
+        sap_[kept++] = p;
+    }
+    sap_.resize(kept);
+
+    std::size_t added = 0;
+    for (int i = 0; i < dynamicCount; ++i)
+    {
+        const ColliderEntry &e = colliders[i];
+        std::uint32_t index = EntityIndex(e.id);
+        if (sapId_[index] == e.id)
+            continue;
+        sapId_[index] = e.id;
+        sap_.push_back(SweepProxy{e.id, i, e.bounds.minX, e.bounds.maxX});
+        added++;
+    }
+
+    // lote grande de novos: ordenar do zero sai mais barato
+    if (added * 8 > sap_.size())
+    {
+        std::sort(sap_.begin(), sap_.end(),
+                  [](const SweepProxy &a, const SweepProxy &b)
+                  { return a.minX < b.minX; });
+        return;
+    }
+    for (std::size_t i = 1; i < sap_.size(); ++i)
+    {
+        SweepProxy p = sap_[i];
+        std::size_t j = i;
+        while (j > 0 && sap_[j - 1].minX > p.minX)
+        {
+            sap_[j] = sap_[j - 1];
+            j--;
+        }
+        sap_[j] = p;
+    }
+}
+
+PhysicsSystem::PhysicsSystem() = default;
+PhysicsSystem::~PhysicsSystem() = default;
+
+void PhysicsSystem::setBroadphase(Broadphase mode)
+{
+    if (mode == broadphase_)
+        return;
+    broadphase_ = mode;
+    clearBroadphase();
+}
+
+void PhysicsSystem::clearBroadphase()
+{
+    tree_.clear();
+    proxies_.clear();
+    querySnapshot_ = false;
+    sap_.clear();
+    sapId_.clear();
+    entryByIndex_.clear();
+    seen_.clear();
+    treeStructure_ = ~0u;
+}
+
+void PhysicsSystem::debugRender(const Scene &scene, std::vector<RenderCommand> &out)
+{
+    out.clear();
+
+    View<const WorldTransform, const ColliderAABB>(scene).each(
+        [&](EntityId id, const WorldTransform &t, const ColliderAABB &c)
+        {
+            RenderCommand cmd;
+            cmd.type = RenderCommandType::Rect;
+            cmd.layer = 100;
+            cmd.x = t.x + c.offsetX;
+            cmd.y = t.y + c.offsetY;
+            cmd.w = (int)c.w;
+            cmd.h = (int)c.h;
+            if (c.isTrigger)
+            {
+                cmd.r = 255;
+                cmd.g = 200;
+                cmd.b = 80;
+                cmd.a = 120;
+            }
+            else if (isSleeping(id))
+            {
+                cmd.r = 110;
+                cmd.g = 110;
+                cmd.b = 160;
+                cmd.a = 120;
+            }
+            else
+            {
+                cmd.r = 220;
+                cmd.g = 80;
+                cmd.b = 80;
+                cmd.a = 120;
+            }
+            out.push_back(cmd);
+        });
+}
+
+void PhysicsSystem::reserveSnapshots(int frames, int maxBodies, int maxPairs)
+{
+    frames = std::max(frames, 1);
+    snapshotMaxBodies_ = std::max(maxBodies, 0);
+    snapshotMaxPairs_ = std::max(maxPairs, 0);
+    snapshotSlots_.assign(frames, SnapshotSlot{});
+    snapshotBodies_.resize((std::size_t)frames * snapshotMaxBodies_);
+    snapshotPairs_.resize((std::size_t)frames * snapshotMaxPairs_);
+    // restore copia para cá: com capacidade reservada o assign não aloca
+    prevPairs_.reserve(snapshotMaxPairs_);
+    nextPairs_.reserve(snapshotMaxPairs_);
+}
+
+std::size_t PhysicsSystem::snapshotBytes() const
+{
+    return snapshotSlots_.size() * sizeof(SnapshotSlot) + snapshotBodies_.size() * sizeof(SnapshotBody) +
+           snapshotPairs_.size() * sizeof(PairCache);
+}
+
+bool PhysicsSystem::hasSnapshot(std::uint32_t frame) const
+{
+    if (snapshotSlots_.empty())
+        return false;
+    const SnapshotSlot &slot = snapshotSlots_[frame % snapshotSlots_.size()];
+    return slot.valid && slot.frame == frame;
+}
+
+// Corpos na ordem dos archetypes/chunks: com a mesma structureVersion o
+// restore percorre na mesma ordem sem procurar ninguém.
+bool PhysicsSystem::saveSnapshot(const Scene &scene, std::uint32_t frame)
+{
+    if (snapshotSlots_.empty())
+        return false;
+    SnapshotSlot &slot = snapshotSlots_[frame % snapshotSlots_.size()];
+    slot.valid = false;
+    if ((int)prevPairs_.size() > snapshotMaxPairs_)
+        return false;
+
+    SnapshotBody *out = snapshotBodies_.data() + (std::size_t)(frame % snapshotSlots_.size()) * snapshotMaxBodies_;
+    int count = 0;
+    for (const Archetype &arch : scene.archetypes())
+    {
+        if ((arch.mask & (ComponentRigidBody | ComponentCollider)) == 0)
+            continue;
+        for (int c = 0; c < arch.chunkCount(); ++c)
+        {
+            int rows = arch.chunkRows(c);
+            if (count + rows > snapshotMaxBodies_)
+                return false;
+            const EntityId *ids = arch.ids.chunk(c);
+            const Transform *transforms = arch.transforms.chunk(c);
+            const WorldTransform *worlds = arch.worlds.chunk(c);
+            const RigidBody2D *bodies = arch.has(ComponentRigidBody) ? arch.rigidbodies.chunk(c) : nullptr;
+            for (int i = 0; i < rows; ++i)
+            {
+                SnapshotBody &b = out[count++];
+                b.id = ids[i];
+                b.x = transforms[i].x;
+                b.y = transforms[i].y;
+                b.worldX = worlds[i].x;
+                b.worldY = worlds[i].y;
+                b.vx = bodies ? bodies[i].vx : 0.0f;
+                b.vy = bodies ? bodies[i].vy : 0.0f;
+                b.flags = 0;
+                std::uint32_t index = EntityIndex(ids[i]);
+                if (index < sleep_.size() && sleep_[index].id == ids[i])
+                {
+                    const SleepState &s = sleep_[index];
+                    b.restX = s.x;
+                    b.restY = s.y;
+                    b.restTime = s.restTime;
+                    b.island = s.island;
+                    b.flags = s.asleep ? 3u : 1u;
+                }
+            }
+        }
+    }
+
+    std::copy(prevPairs_.begin(), prevPairs_.end(),
+              snapshotPairs_.begin() + (std::size_t)(frame % snapshotSlots_.size()) * snapshotMaxPairs_);
+    slot.frame = frame;
+    slot.structureVersion = scene.structureVersion();
+    slot.nextIsland = nextIsland_;
+    slot.bodies = count;
+    slot.pairs = (int)prevPairs_.size();
+    slot.valid = true;
+    return true;
+}
+
+// Escreve direto nas colunas e carimba transform/world (a broadphase refaz
+// os bounds); o tick do rigidbody fica como está para não acordar ninguém.
+bool PhysicsSystem::restoreSnapshot(Scene &scene, std::uint32_t frame)
+{
+    if (!hasSnapshot(frame))
+        return false;
+    std::size_t at = frame % snapshotSlots_.size();
+    const SnapshotSlot &slot = snapshotSlots_[at];
+    const SnapshotBody *in = snapshotBodies_.data() + at * snapshotMaxBodies_;
+
+    std::uint32_t tick = scene.changeTick();
+    auto apply = [&](const SnapshotBody &b, Transform &t, WorldTransform &w, RigidBody2D *body,
+                     std::uint32_t &transformTick, std::uint32_t &worldTick)
+    {
+        t.x = b.x;
+        t.y = b.y;
+        w.x = b.worldX;
+        w.y = b.worldY;
+        transformTick = tick;
+        worldTick = tick;
+        std::uint32_t index = EntityIndex(b.id);
+        if (body)
+        {
+            body->vx = b.vx;
+            body->vy = b.vy;
+            // prev = atual: o primeiro frame não mistura a pose de antes
+            if (index >= interp_.size())
+                interp_.resize(index + 1);
+            interp_[index] = BodyInterp{b.id, b.worldX, b.worldY, b.worldX, b.worldY};
+        }
+        if (index >= sleep_.size())
+            return;
+        SleepState &s = sleep_[index];
+        if (b.flags == 0)
+        {
+            if (s.id == b.id)
+                s = SleepState{};
+            return;
+        }
+        s.id = b.id;
+        s.x = b.restX;
+        s.y = b.restY;
+        s.restTime = b.restTime;
+        s.island = b.island;
+        s.asleep = (b.flags & 2u) != 0;
+        s.sleepTick = tick + 1; // escrita depois do restore acorda
+        s.seen = stepTick_;
+    };
+
+    // mesma estrutura: mesma ordem do save
+    bool ordered = slot.structureVersion == scene.structureVersion();
+    int r = 0;
+    for (Archetype &arch : scene.archetypes())
+    {
+        if (!ordered)
+            break;
+        if ((arch.mask & (ComponentRigidBody | ComponentCollider)) == 0)
+            continue;
+        for (int c = 0; c < arch.chunkCount() && ordered; ++c)
+        {
+            int rows = arch.chunkRows(c);
+            const EntityId *ids = arch.ids.chunk(c);
+            Transform *transforms = arch.transforms.chunk(c);
+            WorldTransform *worlds = arch.worlds.chunk(c);
+            RigidBody2D *bodies = arch.has(ComponentRigidBody) ? arch.rigidbodies.chunk(c) : nullptr;
+            std::uint32_t *transformTicks = arch.ticks<Transform>().chunk(c);
+            std::uint32_t *worldTicks = arch.ticks<WorldTransform>().chunk(c);
+            for (int i = 0; i < rows; ++i)
+            {
+                if (r >= slot.bodies || in[r].id != ids[i])
+                {
+                    ordered = false;
+                    break;
+                }
+                apply(in[r++], transforms[i], worlds[i], bodies ? &bodies[i] : nullptr,
+                      transformTicks[i], worldTicks[i]);
+            }
+        }
+    }
+    if (!ordered || r != slot.bodies)
+    {
+        // estrutura mudou: procura cada um pelo id
+        for (int k = 0; k < slot.bodies; ++k)
+        {
+            int row = 0;
+            Archetype *arch = scene.archetypeOf(in[k].id, row);
+            if (!arch)
+                continue;
+            apply(in[k], arch->transforms[row], arch->worlds[row],
+                  arch->has(ComponentRigidBody) ? &arch->rigidbodies[row] : nullptr,
+                  arch->ticks<Transform>()[row], arch->ticks<WorldTransform>()[row]);
+        }
+    }
+    scene.advanceChangeTick();
+
+    const PairCache *pairs = snapshotPairs_.data() + at * snapshotMaxPairs_;
+    prevPairs_.assign(pairs, pairs + slot.pairs);
+    nextIsland_ = slot.nextIsland;
+    wakeIslands_.clear();
+    events_.clear();
+    querySnapshot_ = false; // consultas voltam a valer no próximo step
+    return true;
+}
+
 void PhysicsSystem::reset()
 {
     prevPairs_.clear();
+    events_.clear();
+    boundsCache_.clear();
+    staticIds_.clear();
+    tileMaps_.clear();
+    sleep_.clear();
+    wakeIslands_.clear();
+    interp_.clear();
+    clearBroadphase();
+    lastStepTick_ = 0;
     stats_ = PhysicsStats{};
 }
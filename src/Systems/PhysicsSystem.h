@@ -1,36 +1,387 @@
 #pragma once
+#include <cstddef>
 #include <cstdint>
-#include <unordered_set>
+#include <vector>
+#include "../Renderer/RenderCommand.h"
+#include "../World/Entity.h"
+#include "AABB.h"
+#include "DynamicAABBTree.h"
+#include "OverlapBatch.h"
+#include "SpatialHash.h"
 
 class Engine;
 class Scene;
 class IScene;
+class ThreadPool;
+struct ColliderEntry;
+struct Tilemap;
 
 struct PhysicsStats
 {
-    int pairsTested = 0;
-    int collisions = 0;
+    int bodiesIntegrated = 0;
+    int colliders = 0;
+    int staticColliders = 0; // kinematic (grade estática)
+    int staticRebuilds = 0;  // 1 quando a grade estática foi refeita no step
+    int collidersRefit = 0;   // AABB recalculado (world/collider mudou)
+    int collidersSkipped = 0; // AABB reaproveitado do step anterior
+    int pairsTested = 0; // candidatos da broadphase que chegaram ao teste exato
+    int collisions = 0;  // pares encontrados (sobreposição real)
     int activePairs = 0;
+    int pairBlocks = 0;   // blocos do narrowphase (1 = serial)
+    int solverContacts = 0;   // contatos sólidos resolvidos pelo solver
+    int solverIterations = 0; // iterações até convergir (<= configurado)
+    int tileContacts = 0; // caixas de tiles sólidos que empurraram um corpo
+    int sweptBodies = 0;  // corpos rápidos que passaram pelo teste contínuo
+    int sweptHits = 0;    // impactos encontrados pelo teste contínuo
+    int awakeBodies = 0;    // não kinematic, acordados no fim do step
+    int sleepingBodies = 0; // fora da integração e da broadphase
+    int treeDepth = 0;  // altura da árvore (Broadphase::Tree)
+    int treeRefits = 0; // proxies que saíram da caixa gorda e foram reinseridos
+    float stepMs = 0.0f;
+};
+
+struct RayQuery
+{
+    float originX = 0.0f;
+    float originY = 0.0f;
+    float dirX = 1.0f; // não precisa estar normalizado
+    float dirY = 0.0f;
+    float maxDistance = 1000.0f;
+    std::uint32_t layerMask = 0xFFFFFFFFu;
+};
+
+struct RaycastHit
+{
+    EntityId id = InvalidEntity; // InvalidEntity = nada
+    float distance = 0.0f;       // 0 se a origem está dentro do collider
+    float x = 0.0f;
+    float y = 0.0f;
+    float normalX = 0.0f; // face atingida (0, 0 se começou dentro)
+    float normalY = 0.0f;
+};
+
+enum class ContactEventType : std::uint8_t
+{
+    Enter,
+    Stay,
+    Exit
+};
+
+// Um contato do step, com a < b (ids). normal aponta de a para b no eixo
+// de menor sobreposição e depth é essa sobreposição, ambos antes de
+// resolver. Exit: normal e depth zerados.
+struct ContactEvent
+{
+    EntityId a = InvalidEntity;
+    EntityId b = InvalidEntity;
+    std::uint32_t layerA = 0;
+    std::uint32_t layerB = 0;
+    float normalX = 0.0f;
+    float normalY = 0.0f;
+    float depth = 0.0f;
+    ContactEventType type = ContactEventType::Enter;
+    bool trigger = false; // algum dos dois é trigger (não houve resolução)
+};
+
+enum class Broadphase
+{
+    Grid, // SpatialHash plano refeito a cada step (buffers reaproveitados)
+    Tree, // DynamicAABBTree persistente, refit incremental
+    Sweep // sweep-and-prune em x, ordem mantida entre steps (insertion sort)
 };
 
 class PhysicsSystem
 {
 public:
+    PhysicsSystem();
+    ~PhysicsSystem();
+
     void setCellSize(int size) { cellSize_ = size; }
     int cellSize() const { return cellSize_; }
+    void setBroadphase(Broadphase mode);
+    Broadphase broadphase() const { return broadphase_; }
+    // Margem da caixa gorda dos proxies da árvore.
+    void setTreeMargin(float margin) { tree_.setMargin(margin); }
+    // Teste contínuo (swept AABB) dos corpos rápidos contra estáticos e
+    // tiles; evita atravessar paredes finas com fixed step maior.
+    void setContinuous(bool enabled) { continuous_ = enabled; }
+    // Solver de contatos: iterações máximas por step e fração do empurrão
+    // do step anterior aplicada antes de iterar (warm start, 0 desliga).
+    void setSolverIterations(int iterations) { solverIterations_ = iterations < 1 ? 1 : iterations; }
+    int solverIterations() const { return solverIterations_; }
+    void setWarmStart(float fraction) { warmStart_ = fraction; }
+    // Sono: ilha de corpos em contato, todos abaixo de speed (px/s) por
+    // delay segundos, sai da integração e da broadphase até algo encostar
+    // andando, o jogo escrever velocidade/posição/forma ou o tilemap mudar.
+    // Ser empurrado para fora de kinematic/dormindo parado não conta como
+    // andar.
+    void setSleeping(bool enabled) { sleepEnabled_ = enabled; }
+    void setSleepThreshold(float speed, float delay)
+    {
+        sleepSpeed_ = speed;
+        sleepDelay_ = delay;
+    }
+    bool isSleeping(EntityId id) const;
+
+    // Interpolação de render: world do rigidbody entre o fim do step
+    // anterior e o do último (alpha 0..1). false se não é corpo ou se foi
+    // movido fora do step; aí vale o world.
+    bool interpolate(EntityId id, const WorldTransform &world, float alpha, float &x, float &y) const;
+    bool continuous() const { return continuous_; }
 
-    void step(Engine &engine, Scene &scene, float fixedDt, IScene *callbacks);
-    void debugRender(Engine &engine, const Scene &scene);
+    // workers: pool para o teste de pares (Engine::workers() no jogo).
+    void step(ThreadPool &workers, Scene &scene, float fixedDt);
+
+    // Eventos do último step: enter/stay na ordem dos pares, depois os exits
+    // ordenados por ids. Vale até o próximo step.
+    const std::vector<ContactEvent> &events() const { return events_; }
+    template <typename Fn>
+    void forEachEventOf(EntityId id, Fn &&fn) const
+    {
+        for (const ContactEvent &e : events_)
+        {
+            if (e.a == id || e.b == id)
+                fn(e);
+        }
+    }
+    // Eventos em que algum dos dois colliders tem bit em layerMask.
+    template <typename Fn>
+    void forEachEventInLayer(std::uint32_t layerMask, Fn &&fn) const
+    {
+        for (const ContactEvent &e : events_)
+        {
+            if ((e.layerA | e.layerB) & layerMask)
+                fn(e);
+        }
+    }
+    // Adaptador para os callbacks do IScene (onCollisionEnter/Stay/Exit).
+    void dispatchEvents(Engine &engine, IScene *callbacks) const;
+    void debugRender(const Scene &scene, std::vector<RenderCommand> &out);
     void reset();
 
+    // Rollback: estado da simulação no fim de um frame (transform, world,
+    // velocidade e sono de quem tem collider ou rigidbody, mais os pares
+    // ativos) num anel de frames pré-alocado por reserveSnapshots; save e
+    // restore não alocam. save devolve false se não couber; restore, se o
+    // frame já saiu do anel. Restaurar e simular de novo dá o mesmo
+    // resultado. Criar/destruir entidades não é desfeito: quem sumiu é
+    // ignorado, quem nasceu depois fica como está.
+    void reserveSnapshots(int frames, int maxBodies, int maxPairs);
+    bool saveSnapshot(const Scene &scene, std::uint32_t frame);
+    bool restoreSnapshot(Scene &scene, std::uint32_t frame);
+    bool hasSnapshot(std::uint32_t frame) const;
+    std::size_t snapshotBytes() const;
+
     const PhysicsStats &stats() const { return stats_; }
 
+    // Consultas espaciais pela broadphase ativa (+ grade estática), filtradas
+    // por ColliderAABB::layerMask. Respondem pelos bounds do último step
+    // (depois de integrar, antes de resolver); quem mexe no scene sem step
+    // (editor) chama refreshQueries antes; ele só refaz se houve escrita
+    // (Scene::writeVersion) e não mexe no sono nem no tick do step. Listas
+    // saem ordenadas (id, ou distância) e são iguais em qualquer broadphase.
+    // As chamadas simples usam um scratch interno: uma thread por vez.
+    void refreshQueries(Scene &scene);
+    bool raycast(const RayQuery &ray, RaycastHit &hit) const;
+    int raycastAll(const RayQuery &ray, std::vector<RaycastHit> &out) const;
+    int overlapBox(const AABB &box, std::vector<EntityId> &out, std::uint32_t layerMask = 0xFFFFFFFFu) const;
+    int overlapPoint(float x, float y, std::vector<EntityId> &out, std::uint32_t layerMask = 0xFFFFFFFFu) const;
+    // Os k mais perto de (x, y) (distância até a caixa), do mais perto ao
+    // mais longe.
+    int nearest(float x, float y, int k, std::vector<EntityId> &out,
+                std::uint32_t layerMask = 0xFFFFFFFFu, float maxDistance = 1.0e9f) const;
+
+    // Lotes (ex.: linha de visão da IA). hits[i] responde rays[i]; com pool
+    // os raios são divididos em blocos nos workers.
+    void raycastBatch(const RayQuery *rays, int count, RaycastHit *hits, ThreadPool *pool = nullptr) const;
+    // Resultado da caixa i em out[offsets[i], offsets[i + 1]).
+    void overlapBoxBatch(const AABB *boxes, int count, std::vector<EntityId> &out,
+                         std::vector<int> &offsets, std::uint32_t layerMask = 0xFFFFFFFFu) const;
+
 private:
-    std::uint64_t pairKey(int a, int b) const;
-    void resolve(Engine &engine, Scene &scene, int idA, int idB);
+    struct QueryScratch
+    {
+        std::vector<int> stack; // pilha da árvore
+        std::vector<int> hits;  // saída do OverlapBatch
+    };
+
+    void collectColliders(Scene &scene, std::uint32_t since, bool simulate);
+    void updateBroadphase(std::uint32_t structureVersion, float fixedDt);
+    void gatherPairs();
+    template <typename Fn>
+    void forEachCandidate(const AABB &box, QueryScratch &scratch, Fn &&fn) const;
+    template <typename Fn>
+    void marchRay(const RayQuery &ray, float dx, float dy, bool first, Fn &&fn) const;
+    bool raycast(const RayQuery &ray, RaycastHit &hit, QueryScratch &scratch) const;
+    std::uint64_t pairKey(std::uint32_t a, std::uint32_t b) const;
+    void testPairs(ThreadPool &pool);
+    void addSolverContact(int ia, int ib, int pair);
+    void solveContacts();
+    struct SleepState;
+    void wake(SleepState &s);
+    void wakeIslands();
+    bool moved(const ColliderEntry &e) const;
+    void wakeTouched();
+    void updateSleep(float fixedDt);
+    bool resolveTile(ColliderEntry &a, const AABB &box);
+    void mapEntries(const std::vector<ColliderEntry> &colliders);
+    struct TileColliders;
+    bool updateTileColliders(const std::vector<Tilemap> &maps);
+    void gatherTileBoxes(const TileColliders &tc, const AABB &box);
+    void collideTiles(std::vector<ColliderEntry> &colliders, int dynamicCount, bool all);
+    void sweepFastBodies(std::vector<ColliderEntry> &colliders, int dynamicCount, float fixedDt);
+    bool earliestHit(const ColliderEntry &e, int dynamicCount, const AABB &a,
+                     float dx, float dy, float &toi, int &axis);
+    void updateStatic(const std::vector<ColliderEntry> &colliders, int dynamicCount);
+    void updateTree(std::vector<ColliderEntry> &colliders, int dynamicCount, std::uint32_t structureVersion, float fixedDt);
+    void updateSweep(const std::vector<ColliderEntry> &colliders, int dynamicCount);
+    void clearBroadphase();
 
 private:
     int cellSize_ = 64;
-    std::unordered_set<std::uint64_t> prevPairs_;
+    std::uint32_t lastStepTick_ = 0; // change tick do scene no último step
+    std::uint32_t stepTick_ = 0;     // tick carimbado pelo step atual
+    std::vector<AABB> boundsCache_;  // por EntityIndex
+    Broadphase broadphase_ = Broadphase::Grid;
+    bool continuous_ = true;
+    int solverIterations_ = 8;
+    float warmStart_ = 0.8f;
+    std::vector<ColliderEntry> colliders_; // do step; bounds/id valem para consultas
+    int dynamicCount_ = 0;                 // colliders_ = [dinâmicos | estáticos]
+    bool querySnapshot_ = false;           // broadphase coerente com colliders_
+    std::uint32_t queryWriteVersion_ = 0;  // Scene::writeVersion do snapshot
+    AABB queryBounds_;                     // união dos bounds do snapshot
+    mutable QueryScratch scratch_;
+    mutable std::vector<QueryScratch> batchScratch_; // um por bloco do raycastBatch
+    std::vector<ColliderEntry> statics_;   // scratch: estáticos antes do append
+    std::vector<std::uint64_t> pairs_;     // candidatos do step (a << 32 | b)
+    std::vector<std::uint64_t> contacts_;  // pares que se sobrepõem, mesma ordem
+    struct PairBlock
+    {
+        std::vector<std::uint64_t> contacts;
+        int tested = 0;
+    };
+    std::vector<PairBlock> pairBlocks_; // buffer por bloco do testPairs
+    SpatialHash grid_;       // só dinâmicos (Broadphase::Grid)
+    SpatialHash staticGrid_; // estáticos; refeita só quando eles mudam
+    std::vector<EntityId> staticIds_; // estáticos na ordem do último rebuild
+    int staticCellSize_ = 0;
+    // Por tilemap (mesmo índice de Scene::tilemaps()): tiles sólidos fundidos
+    // em caixas; boxOf dá a caixa de cada tile (-1: não sólido).
+    struct TileColliders
+    {
+        std::uint32_t version = ~0u;
+        int width = 0;
+        int height = 0;
+        int tileSize = 0;
+        float originX = 0.0f;
+        float originY = 0.0f;
+        std::vector<AABB> boxes;
+        std::vector<int> boxOf;
+    };
+    std::vector<TileColliders> tileMaps_;
+    std::vector<int> tileHits_; // scratch: caixas tocadas por um corpo
+    DynamicAABBTree tree_;
+    std::vector<int> proxies_;          // por EntityIndex: proxy na árvore ou Null
+    struct SweepProxy
+    {
+        EntityId id;
+        int entry; // posição em colliders_ neste step
+        float minX;
+        float maxX;
+    };
+    std::vector<SweepProxy> sap_;       // ordenado por minX
+    BoundsSoA sapBounds_;               // bounds de sap_[k] (teste em lote)
+    float sapMaxWidth_ = 0.0f;          // maior largura em sap_ (consultas)
+    std::vector<int> sapHits_;          // scratch do OverlapBatch
+    std::vector<EntityId> sapId_;       // por EntityIndex: quem está em sap_
+    std::vector<int> entryByIndex_;     // por EntityIndex: posição no step atual
+    std::vector<std::uint32_t> seen_;   // por EntityIndex: último step com collider
+    std::uint32_t stepCount_ = 0;
+    std::uint32_t treeStructure_ = ~0u; // structureVersion da última limpeza
+    // Par ativo (chave: menor id << 32 | maior): layers (a << 32 | b) para
+    // os exits e o manifold do solver para o warm start. Vetor plano
+    // ordenado por chave: snapshot é uma cópia.
+    struct PairCache
+    {
+        std::uint64_t key = 0;
+        std::uint64_t layers = 0;
+        float accumulated = 0.0f; // empurrão total do último step
+        std::int8_t axis = -1;    // -1: sem contato sólido
+    };
+    const PairCache *findPair(std::uint64_t key) const;
+    std::vector<PairCache> prevPairs_;
+    std::vector<PairCache> nextPairs_; // scratch
+    struct SolverContact
+    {
+        int a = 0; // posições em colliders_
+        int b = 0;
+        int pair = 0; // posição em nextPairs_
+        int axis = 0;
+        float sign = 1.0f; // normal de a para b no eixo
+        float wa = 0.5f;   // fração do empurrão de cada lado
+        float wb = 0.5f;
+        float accumulated = 0.0f;
+        bool still = false; // o lado parado (kinematic/dormindo) não andou
+    };
+    std::vector<SolverContact> solverContacts_;
+    std::vector<AABB> solverBounds_; // por collider: posição de trabalho
+    std::vector<float> solverMove_;  // por collider: dx, dy acumulados
+    std::vector<float> stillPush_;   // por collider: parte do solverMove_ vinda de contatos still
+    struct SleepState
+    {
+        EntityId id = InvalidEntity;
+        float x = 0.0f; // world no fim do último step (dormindo: onde dormiu)
+        float y = 0.0f;
+        float restTime = 0.0f;
+        std::uint32_t island = 0;    // rótulo da ilha com que dormiu
+        std::uint32_t sleepTick = 0; // stepTick_ ao dormir; escrita >= acorda
+        std::uint32_t seen = 0;      // stepTick_ em que estava dormindo
+        bool asleep = false;
+    };
+    std::vector<SleepState> sleep_; // por EntityIndex
+    std::vector<std::uint32_t> wakeIslands_;
+    std::vector<int> islandParent_; // scratch do union-find (por collider)
+    std::vector<float> islandRest_;
+    std::vector<std::uint32_t> islandLabel_;
+    std::uint32_t nextIsland_ = 1;
+    bool sleepEnabled_ = true;
+    float sleepSpeed_ = 5.0f;
+    float sleepDelay_ = 0.5f;
+    struct BodyInterp
+    {
+        EntityId id = InvalidEntity;
+        float prevX = 0.0f; // world no início do último step
+        float prevY = 0.0f;
+        float x = 0.0f; // world no fim do último step
+        float y = 0.0f;
+    };
+    std::vector<BodyInterp> interp_; // por EntityIndex
+    // 48 bytes por corpo; flags: 1 = tem SleepState, 2 = dormindo
+    struct SnapshotBody
+    {
+        EntityId id;
+        float x, y;
+        float worldX, worldY;
+        float vx, vy;
+        float restX, restY, restTime;
+        std::uint32_t island;
+        std::uint32_t flags;
+    };
+    struct SnapshotSlot
+    {
+        std::uint32_t frame = 0;
+        std::uint32_t structureVersion = 0;
+        std::uint32_t nextIsland = 1;
+        int bodies = 0;
+        int pairs = 0;
+        bool valid = false;
+    };
+    std::vector<SnapshotSlot> snapshotSlots_;
+    std::vector<SnapshotBody> snapshotBodies_; // slot * snapshotMaxBodies_
+    std::vector<PairCache> snapshotPairs_;     // slot * snapshotMaxPairs_
+    int snapshotMaxBodies_ = 0;
+    int snapshotMaxPairs_ = 0;
+    std::vector<ContactEvent> events_;
     PhysicsStats stats_;
 };
@@ -1,43 +1,198 @@
 #include "RenderSystem.h"
 #include "../Engine/Engine.h"
 #include "../World/Scene.h"
+#include "../World/View.h"
+#include "../Time/Stopwatch.h"
 
-void RenderSystem::render(Engine &engine, const Scene &scene)
+static void BuildRect(RenderCommand &cmd, const WorldTransform &t, const RectRender &rect)
 {
-    auto &q = engine.commandBuffer();
+    cmd = RenderCommand{};
+    cmd.type = RenderCommandType::Rect;
+    cmd.layer = rect.layer;
+    cmd.x = t.x;
+    cmd.y = t.y;
+    cmd.w = rect.w;
+    cmd.h = rect.h;
+    cmd.r = rect.r;
+    cmd.g = rect.g;
+    cmd.b = rect.b;
+    cmd.a = rect.a;
+}
+
+// Sprite sem textura cai no rect, se houver; false = linha não desenha nada.
+static bool BuildProxy(RenderCommand &cmd, const WorldTransform &t, const SpriteRender *sprite, const RectRender *rect)
+{
+    if (!sprite || sprite->texture == InvalidTexture)
+    {
+        if (!rect)
+            return false;
+        BuildRect(cmd, t, *rect);
+        return true;
+    }
+
+    cmd = RenderCommand{};
+    cmd.type = RenderCommandType::Sprite;
+    cmd.layer = sprite->layer;
+    cmd.x = t.x;
+    cmd.y = t.y;
+    cmd.texture = sprite->texture;
+    cmd.scale = sprite->scale;
+    cmd.rotationDeg = sprite->rotationDeg;
+    return true;
+}
+
+// Colunas de sprite/rect de um chunk. step 0 = componente compartilhado
+// por prefab (um valor para todas as linhas).
+struct DrawableChunk
+{
+    const EntityId *ids = nullptr;
+    const WorldTransform *transforms = nullptr;
+    const SpriteRender *sprites = nullptr;
+    const RectRender *rects = nullptr;
+    int spriteStep = 1;
+    int rectStep = 1;
+
+    const SpriteRender *sprite(int i) const { return sprites ? &sprites[i * spriteStep] : nullptr; }
+    const RectRender *rect(int i) const { return rects ? &rects[i * rectStep] : nullptr; }
+};
+
+// Visita as linhas desenháveis sempre na mesma ordem: rect puro, depois
+// sprite. fn(const Archetype &, int chunk, int count, const DrawableChunk &)
+template <typename Fn>
+static void ForEachDrawableChunk(const Scene &scene, Fn &&fn)
+{
+    View<const WorldTransform, const RectRender>(scene).exclude(ComponentSprite).eachChunk(
+        [&](const Archetype &arch, int c, int count, const EntityId *ids,
+            const WorldTransform *transforms, const RectRender *rects)
+        {
+            DrawableChunk chunk;
+            chunk.ids = ids;
+            chunk.transforms = transforms;
+            chunk.rects = rects;
+            chunk.rectStep = arch.step<RectRender>();
+            fn(arch, c, count, chunk);
+        });
+
+    View<const WorldTransform, const SpriteRender>(scene).eachChunk(
+        [&](const Archetype &arch, int c, int count, const EntityId *ids,
+            const WorldTransform *transforms, const SpriteRender *sprites)
+        {
+            DrawableChunk chunk;
+            chunk.ids = ids;
+            chunk.transforms = transforms;
+            chunk.sprites = sprites;
+            chunk.spriteStep = arch.step<SpriteRender>();
+            if (arch.owns(ComponentRect))
+                chunk.rects = arch.rects.chunk(c);
+            else if (arch.has(ComponentRect))
+            {
+                chunk.rects = &arch.shared->rect;
+                chunk.rectStep = 0;
+            }
+            fn(arch, c, count, chunk);
+        });
+}
+
+void RenderSystem::render(const Engine &engine, const Scene &scene, std::vector<RenderCommand> &out)
+{
+    Stopwatch timer;
+    stats_ = RenderSystemStats{};
 
-    for (const auto &e : scene.entities())
+    std::uint32_t since = lastTick_;
+    lastTick_ = scene.changeTick();
+
+    bool interpolating = engine.renderInterpolation();
+    physics_ = interpolating ? &engine.physics() : nullptr;
+    alpha_ = engine.renderAlpha();
+    // ligou/desligou: os proxies guardados estão na outra posição
+    bool toggled = interpolating != interpolating_;
+    interpolating_ = interpolating;
+
+    if (toggled || scene.structureVersion() != structureVersion_ || !update(scene, out, since))
+        rebuild(scene, out);
+    structureVersion_ = scene.structureVersion();
+
+    stats_.buildMs = timer.elapsedMs();
+}
+
+// Corpo da física: posição entre os dois últimos fixed steps.
+void RenderSystem::interpolate(RenderCommand &cmd, EntityId id, const WorldTransform &t)
+{
+    if (physics_ && physics_->interpolate(id, t, alpha_, cmd.x, cmd.y))
+        stats_.interpolated++;
+}
+
+void RenderSystem::rebuild(const Scene &scene, std::vector<RenderCommand> &out)
+{
+    stats_ = RenderSystemStats{};
+    stats_.rebuilt = true;
+    out.clear();
+    slots_.clear();
+
+    auto visit = [&](const Archetype &, int, int count, const DrawableChunk &chunk)
     {
-        // Sprite
-        if (e.sprite.enabled && e.sprite.texture)
+        stats_.entitiesVisited += count;
+        for (int i = 0; i < count; ++i)
         {
             RenderCommand cmd;
-            cmd.type = RenderCommandType::Sprite;
-            cmd.layer = e.renderLayer; // depois vira componente
-            cmd.x = e.transform.x;
-            cmd.y = e.transform.y;
-            cmd.texture = e.sprite.texture.get();
-            cmd.scale = e.sprite.scale;
-            cmd.rotationDeg = e.sprite.rotationDeg;
-            q.submit(cmd);
-            continue;
+            if (!BuildProxy(cmd, chunk.transforms[i], chunk.sprite(i), chunk.rect(i)))
+            {
+                slots_.push_back(-1);
+                continue;
+            }
+            interpolate(cmd, chunk.ids[i], chunk.transforms[i]);
+            slots_.push_back((int)out.size());
+            out.push_back(cmd);
         }
+    };
+    ForEachDrawableChunk(scene, visit);
+}
 
-        // Rect fallback
-        if (e.rect.enabled)
+bool RenderSystem::update(const Scene &scene, std::vector<RenderCommand> &out, std::uint32_t since)
+{
+    std::size_t row = 0;
+    bool ok = true;
+
+    auto visit = [&](const Archetype &arch, int c, int count, const DrawableChunk &chunk)
+    {
+        if (!ok)
+            return;
+        const std::uint32_t *transformTicks = arch.ticks<WorldTransform>().chunk(c);
+        const std::uint32_t *spriteTicks = chunk.sprites ? arch.ticks<SpriteRender>().chunk(c) : nullptr;
+        const std::uint32_t *rectTicks = chunk.rects ? arch.ticks<RectRender>().chunk(c) : nullptr;
+
+        stats_.entitiesVisited += count;
+        for (int i = 0; i < count; ++i, ++row)
         {
+            bool changed = transformTicks[i] > since ||
+                           (spriteTicks && spriteTicks[i] > since) ||
+                           (rectTicks && rectTicks[i] > since);
+            if (!changed)
+            {
+                // proxy igual; só a posição interpolada anda entre steps
+                stats_.entitiesSkipped++;
+                int slot = row < slots_.size() ? slots_[row] : -1;
+                if (physics_ && slot >= 0 && slot < (int)out.size())
+                    interpolate(out[slot], chunk.ids[i], chunk.transforms[i]);
+                continue;
+            }
+
             RenderCommand cmd;
-            cmd.type = RenderCommandType::Rect;
-            cmd.layer = e.renderLayer;
-            cmd.x = e.transform.x;
-            cmd.y = e.transform.y;
-            cmd.w = e.rect.w;
-            cmd.h = e.rect.h;
-            cmd.r = e.rect.r;
-            cmd.g = e.rect.g;
-            cmd.b = e.rect.b;
-            cmd.a = e.rect.a;
-            q.submit(cmd);
+            bool drawn = BuildProxy(cmd, chunk.transforms[i], chunk.sprite(i), chunk.rect(i));
+            int slot = row < slots_.size() ? slots_[row] : -1;
+            if (row >= slots_.size() || drawn != (slot >= 0) || slot >= (int)out.size())
+            {
+                ok = false; // linha passou a (não) desenhar: refaz a lista
+                return;
+            }
+            if (drawn)
+            {
+                interpolate(cmd, chunk.ids[i], chunk.transforms[i]);
+                out[slot] = cmd;
+            }
         }
-    }
+    };
+    ForEachDrawableChunk(scene, visit);
+
+    return ok && row == slots_.size();
 }
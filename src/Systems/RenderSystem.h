@@ -1,10 +1,45 @@
 #pragma once
+#include <cstdint>
+#include <vector>
+#include "../Renderer/RenderCommand.h"
+#include "../World/Entity.h"
 
 class Engine;
 class Scene;
+class PhysicsSystem;
+
+struct RenderSystemStats
+{
+    int entitiesVisited = 0;
+    int entitiesSkipped = 0; // proxy reaproveitado (nada mudou desde o frame anterior)
+    int interpolated = 0;    // corpos desenhados entre dois fixed steps
+    bool rebuilt = false;    // estrutura mudou: lista refeita do zero
+    float buildMs = 0.0f;
+};
 
 class RenderSystem
 {
 public:
-    void render(Engine &engine, const Scene &scene);
+    // Gera os comandos de sprites/rects em out (lista própria do sistema).
+    // out é persistente: se nenhuma entidade foi criada/removida, só os
+    // proxies das linhas alteradas desde a última chamada são refeitos.
+    // Com Engine::renderInterpolation, corpos da física ficam na posição
+    // interpolada (só x/y do proxy, todo frame).
+    void render(const Engine &engine, const Scene &scene, std::vector<RenderCommand> &out);
+
+    const RenderSystemStats &stats() const { return stats_; }
+
+private:
+    void rebuild(const Scene &scene, std::vector<RenderCommand> &out);
+    bool update(const Scene &scene, std::vector<RenderCommand> &out, std::uint32_t since);
+    void interpolate(RenderCommand &cmd, EntityId id, const WorldTransform &t);
+
+private:
+    RenderSystemStats stats_;
+    std::vector<int> slots_; // por linha visitada: índice em out ou -1
+    std::uint32_t lastTick_ = 0;
+    std::uint32_t structureVersion_ = ~0u;
+    const PhysicsSystem *physics_ = nullptr; // do frame; nullptr = sem interpolação
+    float alpha_ = 1.0f;
+    bool interpolating_ = false; // estado do frame anterior
 };
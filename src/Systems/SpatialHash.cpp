@@ -0,0 +1,57 @@
+#include "SpatialHash.h"
+#include <cmath>
+
+void SpatialHash::clear(float cellSize)
+{
+    invCell_ = 1.0f / cellSize;
+    items_.clear();
+}
+
+int SpatialHash::CellCoord(float v) const
+{
+    return (int)std::floor(v * invCell_);
+}
+
+void SpatialHash::insert(int index, const AABB &box)
+{
+    int minCx = CellCoord(box.minX);
+    int maxCx = CellCoord(box.maxX);
+    int minCy = CellCoord(box.minY);
+    int maxCy = CellCoord(box.maxY);
+    if (index >= (int)ranges_.size())
+        ranges_.resize(index + 1);
+    ranges_[index] = CellRange{minCx, minCy};
+    for (int cy = minCy; cy <= maxCy; ++cy)
+    {
+        for (int cx = minCx; cx <= maxCx; ++cx)
+            items_.push_back(Item{CellKey(cx, cy), index});
+    }
+}
+
+void SpatialHash::finalize()
+{
+    // ~2 buckets por item, potência de 2 (hash = bits altos do produto)
+    std::size_t count = items_.size();
+    bucketBits_ = 1;
+    while (((std::size_t)1 << bucketBits_) < count * 2)
+        bucketBits_++;
+    std::size_t bucketCount = (std::size_t)1 << bucketBits_;
+
+    bucketStart_.assign(bucketCount + 1, 0);
+    buckets_.resize(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        std::uint32_t b = BucketOf(items_[i].cell);
+        buckets_[i] = b;
+        bucketStart_[b + 1]++;
+    }
+    for (std::size_t b = 0; b < bucketCount; ++b)
+        bucketStart_[b + 1] += bucketStart_[b];
+
+    // scatter estável: dentro do bucket fica a ordem de inserção
+    sorted_.resize(count);
+    std::vector<int> &cursor = scratch_;
+    cursor.assign(bucketStart_.begin(), bucketStart_.end() - 1);
+    for (std::size_t i = 0; i < count; ++i)
+        sorted_[cursor[buckets_[i]]++] = items_[i];
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "AABB.h"
+
+// Grade uniforme em arrays planos, refeita a cada step sem alocar (os
+// buffers só crescem). insert() grava um (célula, índice) por célula
+// coberta; finalize() agrupa por bucket de hash com counting sort, então
+// cada bucket é um trecho contíguo de items_.
+class SpatialHash
+{
+public:
+    void clear(float cellSize);
+    void insert(int index, const AABB &box);
+    void finalize();
+
+    // fn(int a, int b) uma vez para cada par de índices que dividem alguma
+    // célula: o par pertence à primeira célula em comum (menor cx, cy da
+    // interseção dos intervalos), as outras células o ignoram.
+    template <typename Fn>
+    void forEachPair(Fn &&fn) const
+    {
+        for (std::size_t b = 0; b + 1 < bucketStart_.size(); ++b)
+        {
+            int begin = bucketStart_[b];
+            int end = bucketStart_[b + 1];
+            for (int i = begin; i < end; ++i)
+            {
+                const Item &p = sorted_[i];
+                for (int j = i + 1; j < end; ++j)
+                {
+                    const Item &q = sorted_[j];
+                    // buckets misturam células com o mesmo hash
+                    if (p.cell != q.cell)
+                        continue;
+                    const CellRange &ra = ranges_[p.index];
+                    const CellRange &rb = ranges_[q.index];
+                    int ownerX = ra.minCx > rb.minCx ? ra.minCx : rb.minCx;
+                    int ownerY = ra.minCy > rb.minCy ? ra.minCy : rb.minCy;
+                    if (p.cell == CellKey(ownerX, ownerY))
+                        fn(p.index, q.index);
+                }
+            }
+        }
+    }
+
+    // fn(int index) uma vez para cada índice que divide alguma célula com
+    // box; mesma regra de dono do forEachPair (a grade não muda).
+    template <typename Fn>
+    void query(const AABB &box, Fn &&fn) const
+    {
+        if (items_.empty())
+            return;
+        int minCx = CellCoord(box.minX);
+        int maxCx = CellCoord(box.maxX);
+        int minCy = CellCoord(box.minY);
+        int maxCy = CellCoord(box.maxY);
+        for (int cy = minCy; cy <= maxCy; ++cy)
+        {
+            for (int cx = minCx; cx <= maxCx; ++cx)
+            {
+                std::uint64_t cell = CellKey(cx, cy);
+                std::uint32_t b = BucketOf(cell);
+                for (int i = bucketStart_[b]; i < bucketStart_[b + 1]; ++i)
+                {
+                    const Item &p = sorted_[i];
+                    if (p.cell != cell)
+                        continue;
+                    const CellRange &r = ranges_[p.index];
+                    int ownerX = minCx > r.minCx ? minCx : r.minCx;
+                    int ownerY = minCy > r.minCy ? minCy : r.minCy;
+                    if (cx == ownerX && cy == ownerY)
+                        fn(p.index);
+                }
+            }
+        }
+    }
+
+    std::size_t entryCount() const { return items_.size(); }
+    std::size_t bucketCount() const { return bucketStart_.empty() ? 0 : bucketStart_.size() - 1; }
+
+private:
+    struct Item
+    {
+        std::uint64_t cell = 0;
+        int index = 0;
+    };
+
+    struct CellRange
+    {
+        int minCx = 0;
+        int minCy = 0;
+    };
+
+    static std::uint64_t CellKey(int cx, int cy)
+    {
+        return ((std::uint64_t)(std::uint32_t)cx << 32) | (std::uint32_t)cy;
+    }
+
+    int CellCoord(float v) const;
+    std::uint32_t BucketOf(std::uint64_t cell) const
+    {
+        return (std::uint32_t)((cell * 0x9E3779B97F4A7C15ull) >> (64 - bucketBits_));
+    }
+
+private:
+    float invCell_ = 1.0f / 64.0f;
+    int bucketBits_ = 0;
+    std::vector<Item> items_;
+    std::vector<CellRange> ranges_; // por índice: primeira célula coberta
+    std::vector<Item> sorted_;
+    std::vector<std::uint32_t> buckets_; // bucket de cada item (scratch)
+    std::vector<int> bucketStart_;       // prefixo: bucket b = [start[b], start[b+1])
+    std::vector<int> scratch_;           // cursores do scatter
+};
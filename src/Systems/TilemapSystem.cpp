@@ -27,9 +27,9 @@ static TileColor ColorForTile(int id)
     return palette[index];
 }
 
-void TilemapSystem::render(Engine &engine, const Scene &scene)
+void TilemapSystem::render(const Engine &engine, const Scene &scene, std::vector<RenderCommand> &out)
 {
-    auto &q = engine.commandBuffer();
+    out.clear();
 
     float wx0 = 0.0f;
     float wy0 = 0.0f;
@@ -79,7 +79,7 @@ void TilemapSystem::render(Engine &engine, const Scene &scene)
                 cmd.g = c.g;
                 cmd.b = c.b;
                 cmd.a = c.a;
-                q.submit(cmd);
+                out.push_back(cmd);
             }
         }
     }
@@ -1,4 +1,6 @@
 #pragma once
+#include <vector>
+#include "../Renderer/RenderCommand.h"
 
 class Engine;
 class Scene;
@@ -6,5 +8,6 @@ class Scene;
 class TilemapSystem
 {
 public:
-    void render(Engine &engine, const Scene &scene);
+    // Gera os comandos dos tiles visíveis em out (lista própria do sistema).
+    void render(const Engine &engine, const Scene &scene, std::vector<RenderCommand> &out);
 };
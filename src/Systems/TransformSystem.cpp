@@ -0,0 +1,213 @@
+#include "TransformSystem.h"
+#include "../World/Scene.h"
+#include "../World/View.h"
+#include "../Time/Stopwatch.h"
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+
+void TransformSystem::update(Scene &scene)
+{
+    Stopwatch timer;
+    stats_ = TransformStats{};
+
+    std::uint32_t since = lastTick_;
+    std::uint32_t tick = scene.changeTick();
+
+    bool rebuilt = scene.hierarchyVersion() != hierarchyVersion_;
+    if (rebuilt)
+    {
+        rebuildOrder(scene);
+        hierarchyVersion_ = scene.hierarchyVersion();
+        // ordem nova: todos sujos (nodes_ crescente já é um heap mínimo)
+        dirty_.resize(nodes_.size());
+        for (int i = 0; i < (int)nodes_.size(); ++i)
+            dirty_[i] = i;
+        queued_.assign(nodes_.size(), 1);
+    }
+
+    // Raízes: world = local, só onde o local mudou; os filhos ficam sujos
+    View<const Transform, WorldTransform>(scene)
+        .exclude(ComponentParent)
+        .changedSince(ComponentTransform, since)
+        .each([&](EntityId id, const Transform &t, WorldTransform &w)
+              {
+                  w.x = t.x;
+                  w.y = t.y;
+                  stats_.rootsUpdated++;
+                  markChildren(id, -1);
+              });
+
+    // Nós com local ou pai escrito desde o último update
+    if (!rebuilt)
+    {
+        View<const Parent>(scene)
+            .changedSince(ComponentTransform | ComponentParent, since)
+            .each([&](EntityId id, const Parent &)
+                  { markNode(id); });
+    }
+
+    // Menor posição primeiro: o pai sai do heap antes dos filhos que ele suja
+    while (!dirty_.empty())
+    {
+        std::pop_heap(dirty_.begin(), dirty_.end(), std::greater<int>());
+        int index = dirty_.back();
+        dirty_.pop_back();
+        queued_[index] = 0;
+
+        const Node &node = nodes_[index];
+        int row = 0;
+        Archetype *arch = scene.archetypeOf(node.id, row);
+        if (!arch || !arch->has(ComponentParent))
+            continue;
+
+        int parentRow = 0;
+        const Archetype *parentArch = scene.archetypeOf(node.parent, parentRow);
+
+        const Transform &local = arch->transforms[row];
+        WorldTransform &world = arch->worlds[row];
+        world.x = local.x;
+        world.y = local.y;
+        if (parentArch) // pai destruído: o nó vira raiz
+        {
+            world.x += parentArch->worlds[parentRow].x;
+            world.y += parentArch->worlds[parentRow].y;
+        }
+        arch->ticks<WorldTransform>()[row] = tick;
+        stats_.recomputed++;
+        markChildren(node.id, index);
+    }
+
+    stats_.nodes = (int)nodes_.size();
+    stats_.skipped = stats_.nodes - stats_.recomputed;
+    stats_.maxDepth = nodes_.empty() ? 0 : nodes_.back().depth;
+    stats_.rebuiltOrder = rebuilt;
+    if (stats_.rootsUpdated + stats_.recomputed > 0)
+        scene.noteWrite(); // world escrito por view/acesso cru
+
+    // Avança depois de carimbar: o próximo update não vê as próprias escritas
+    lastTick_ = scene.advanceChangeTick();
+    stats_.updateMs = timer.elapsedMs();
+}
+
+void TransformSystem::rebuildOrder(const Scene &scene)
+{
+    nodes_.clear();
+    View<const Parent>(scene).eachChunk(
+        [&](const Archetype &, int, int count, const EntityId *ids, const Parent *parents)
+        {
+            for (int i = 0; i < count; ++i)
+                nodes_.push_back(Node{ids[i], parents[i].id, -1});
+        });
+
+    std::uint32_t maxIndex = 0;
+    for (const Node &node : nodes_)
+        maxIndex = std::max(maxIndex, EntityIndex(node.id));
+    nodeByIndex_.assign(nodes_.empty() ? 0 : maxIndex + 1, -1);
+    for (int i = 0; i < (int)nodes_.size(); ++i)
+        nodeByIndex_[EntityIndex(nodes_[i].id)] = i;
+
+    // Posição do pai em nodes_, ou -1 se o pai é raiz (ou morreu).
+    auto parentNode = [&](int i) -> int
+    {
+        EntityId parent = nodes_[i].parent;
+        std::uint32_t index = EntityIndex(parent);
+        if (index >= nodeByIndex_.size())
+            return -1;
+        int p = nodeByIndex_[index];
+        return (p >= 0 && nodes_[p].id == parent) ? p : -1;
+    };
+
+    // Profundidade sem recursão: sobe até um nó já resolvido e desce
+    // numerando a cadeia. -2 marca "na pilha" para detectar ciclos.
+    std::vector<int> chain;
+    for (int i = 0; i < (int)nodes_.size(); ++i)
+    {
+        if (nodes_[i].depth >= 0)
+            continue;
+        int cur = i;
+        while (cur >= 0 && nodes_[cur].depth == -1)
+        {
+            nodes_[cur].depth = -2;
+            chain.push_back(cur);
+            cur = parentNode(cur);
+        }
+        int depth = 0;
+        if (cur >= 0 && nodes_[cur].depth == -2)
+            std::printf("TransformSystem: parent cycle at entity %u\n", nodes_[cur].id);
+        else if (cur >= 0)
+            depth = nodes_[cur].depth;
+        while (!chain.empty())
+        {
+            nodes_[chain.back()].depth = ++depth;
+            chain.pop_back();
+        }
+    }
+
+    std::stable_sort(nodes_.begin(), nodes_.end(),
+                     [](const Node &a, const Node &b)
+                     { return a.depth < b.depth; });
+    for (int i = 0; i < (int)nodes_.size(); ++i)
+        nodeByIndex_[EntityIndex(nodes_[i].id)] = i;
+
+    // Filhos de cada pai (raiz ou nó), já em ordem de profundidade
+    std::uint32_t maxParent = 0;
+    for (const Node &node : nodes_)
+        maxParent = std::max(maxParent, EntityIndex(node.parent));
+    childStart_.assign(nodes_.empty() ? 0 : maxParent + 2, 0);
+    for (const Node &node : nodes_)
+        childStart_[EntityIndex(node.parent) + 1]++;
+    for (std::size_t i = 1; i < childStart_.size(); ++i)
+        childStart_[i] += childStart_[i - 1];
+    children_.resize(nodes_.size());
+    std::vector<int> fill(childStart_);
+    for (int i = 0; i < (int)nodes_.size(); ++i)
+        children_[fill[EntityIndex(nodes_[i].parent)]++] = i;
+}
+
+void TransformSystem::queueNode(int node)
+{
+    if (queued_[node])
+        return;
+    queued_[node] = 1;
+    dirty_.push_back(node);
+    std::push_heap(dirty_.begin(), dirty_.end(), std::greater<int>());
+}
+
+void TransformSystem::markNode(EntityId id)
+{
+    std::uint32_t index = EntityIndex(id);
+    if (index >= nodeByIndex_.size())
+        return;
+    int node = nodeByIndex_[index];
+    if (node >= 0 && nodes_[node].id == id)
+        queueNode(node);
+}
+
+// Só filhos depois de from em nodes_: num ciclo (depth inválido) a sujeira
+// não volta para trás.
+void TransformSystem::markChildren(EntityId parent, int from)
+{
+    std::uint32_t index = EntityIndex(parent);
+    if (index + 1 >= childStart_.size())
+        return;
+    for (int k = childStart_[index]; k < childStart_[index + 1]; ++k)
+    {
+        int node = children_[k];
+        if (node > from && nodes_[node].parent == parent)
+            queueNode(node);
+    }
+}
+
+void TransformSystem::reset()
+{
+    nodes_.clear();
+    nodeByIndex_.clear();
+    childStart_.clear();
+    children_.clear();
+    dirty_.clear();
+    queued_.clear();
+    lastTick_ = 0;
+    hierarchyVersion_ = ~0u;
+    stats_ = TransformStats{};
+}
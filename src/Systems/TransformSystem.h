@@ -0,0 +1,54 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "../World/Entity.h"
+
+class Scene;
+
+struct TransformStats
+{
+    int rootsUpdated = 0;      // raízes cujo Transform mudou (world = local)
+    int nodes = 0;             // entidades com Parent
+    int recomputed = 0;        // nós com world refeito (subárvore suja)
+    int skipped = 0;           // nós sem mudança própria nem do pai
+    int maxDepth = 0;
+    bool rebuiltOrder = false; // hierarquia mudou: ordem por profundidade refeita
+    float updateMs = 0.0f;
+};
+
+class TransformSystem
+{
+public:
+    // Atualiza o WorldTransform de quem mudou desde a última chamada. Raízes
+    // copiam o local; só os nós sujos (local/pai alterado ou world do pai
+    // refeito) são visitados, em ordem de profundidade (pai antes do filho),
+    // e cada um suja os filhos. Subárvores limpas não são tocadas.
+    void update(Scene &scene);
+    void reset();
+
+    const TransformStats &stats() const { return stats_; }
+
+private:
+    struct Node
+    {
+        EntityId id = InvalidEntity;
+        EntityId parent = InvalidEntity;
+        int depth = 0;
+    };
+
+    void rebuildOrder(const Scene &scene);
+    void queueNode(int node);
+    void markNode(EntityId id);
+    void markChildren(EntityId parent, int from);
+
+private:
+    TransformStats stats_;
+    std::vector<Node> nodes_; // ordenado por profundidade
+    std::vector<int> nodeByIndex_; // EntityIndex -> posição em nodes_
+    std::vector<int> childStart_;  // EntityIndex do pai -> faixa em children_
+    std::vector<int> children_;    // posições em nodes_, agrupadas por pai
+    std::vector<int> dirty_;       // heap mínimo de posições (profundidade crescente)
+    std::vector<char> queued_;     // posição já está em dirty_
+    std::uint32_t lastTick_ = 0;
+    std::uint32_t hierarchyVersion_ = ~0u;
+};
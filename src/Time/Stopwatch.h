@@ -0,0 +1,19 @@
+#pragma once
+#include <chrono>
+
+// Tempo de parede de um trecho, em ms (stats dos sistemas).
+class Stopwatch
+{
+public:
+    Stopwatch() : start_(Clock::now()) {}
+
+    void restart() { start_ = Clock::now(); }
+    float elapsedMs() const
+    {
+        return std::chrono::duration<float, std::milli>(Clock::now() - start_).count();
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point start_;
+};
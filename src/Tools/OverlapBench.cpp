@@ -0,0 +1,75 @@
+// Micro-benchmark dos kernels do OverlapBatch: mesma cena (caixas
+// aleatórias ordenadas por minX, janela como a do sweep-and-prune) em cada
+// kernel suportado. Uso: overlap_bench [caixas] [repetições]
+#include "../Systems/OverlapBatch.h"
+#include "../Time/Stopwatch.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+int main(int argc, char **argv)
+{
+    int count = argc > 1 ? std::atoi(argv[1]) : 20000;
+    int repeats = argc > 2 ? std::atoi(argv[2]) : 20;
+    if (count <= 0 || repeats <= 0)
+        return 1;
+
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> pos(0.0f, 4000.0f);
+    std::uniform_real_distribution<float> size(8.0f, 64.0f);
+    std::vector<AABB> boxes(count);
+    for (AABB &b : boxes)
+    {
+        float x = pos(rng);
+        float y = pos(rng);
+        b = AABB{x, y, x + size(rng), y + size(rng)};
+    }
+    std::sort(boxes.begin(), boxes.end(), [](const AABB &a, const AABB &b)
+              { return a.minX < b.minX; });
+
+    BoundsSoA soa;
+    soa.resize(count);
+    for (int i = 0; i < count; ++i)
+        soa.set(i, boxes[i]);
+    std::vector<int> hits(count);
+
+    const OverlapKernel kernels[] = {OverlapKernel::Scalar, OverlapKernel::SSE2, OverlapKernel::AVX2};
+    long long expected = -1;
+    float scalarMs = 0.0f;
+    for (OverlapKernel kernel : kernels)
+    {
+        if (!SetOverlapKernel(kernel))
+        {
+            std::printf("%-7s unsupported\n", OverlapKernelName(kernel));
+            continue;
+        }
+
+        long long found = 0;
+        long long tested = 0;
+        Stopwatch timer;
+        for (int r = 0; r < repeats; ++r)
+        {
+            for (int i = 0; i < count; ++i)
+            {
+                int end = i + 1;
+                while (end < count && soa.minX[end] <= boxes[i].maxX)
+                    end++;
+                tested += end - (i + 1);
+                found += OverlapBatch(boxes[i], soa, i + 1, end, hits.data());
+            }
+        }
+        float ms = timer.elapsedMs();
+        if (kernel == OverlapKernel::Scalar)
+            scalarMs = ms;
+
+        std::printf("%-7s %8.2f ms  %6.2f ns/test  hits %lld  x%.2f%s\n",
+                    OverlapKernelName(kernel), ms, ms * 1.0e6f / (float)std::max(tested, 1LL), found,
+                    ms > 0.0f ? scalarMs / ms : 0.0f,
+                    expected >= 0 && found != expected ? "  MISMATCH" : "");
+        if (expected < 0)
+            expected = found;
+    }
+    return 0;
+}
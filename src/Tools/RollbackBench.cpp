@@ -0,0 +1,122 @@
+// Micro-benchmark do rollback da física: salva um snapshot por frame,
+// volta rollback frames e simula de novo até o presente, conferindo que o
+// resultado bate com a primeira simulação. Uso:
+// rollback_bench [corpos] [frames de rollback] [repetições]
+#include "../Engine/ThreadPool.h"
+#include "../Systems/PhysicsSystem.h"
+#include "../Time/Stopwatch.h"
+#include "../World/Scene.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+// Hash dos bits de posição e velocidade de todos os corpos.
+static std::uint64_t StateHash(const Scene &scene)
+{
+    std::uint64_t h = 1469598103934665603ull;
+    auto mix = [&h](float v)
+    {
+        std::uint32_t bits = 0;
+        std::memcpy(&bits, &v, sizeof(bits));
+        h = (h ^ bits) * 1099511628211ull;
+    };
+    for (const Archetype &arch : scene.archetypes())
+    {
+        if (!arch.has(ComponentRigidBody))
+            continue;
+        for (std::size_t row = 0; row < arch.size(); ++row)
+        {
+            mix(arch.worlds[row].x);
+            mix(arch.worlds[row].y);
+            mix(arch.rigidbodies[row].vx);
+            mix(arch.rigidbodies[row].vy);
+        }
+    }
+    return h;
+}
+
+int main(int argc, char **argv)
+{
+    int count = argc > 1 ? std::atoi(argv[1]) : 10000;
+    int rollback = argc > 2 ? std::atoi(argv[2]) : 8;
+    int repeats = argc > 3 ? std::atoi(argv[3]) : 20;
+    if (count <= 0 || rollback <= 0 || repeats <= 0)
+        return 1;
+    const float dt = 1.0f / 60.0f;
+
+    ThreadPool workers;
+    Scene scene;
+    std::mt19937 rng(4321);
+    std::uniform_real_distribution<float> pos(0.0f, 4000.0f);
+    std::uniform_real_distribution<float> vel(-120.0f, 120.0f);
+    for (int i = 0; i < count; ++i)
+    {
+        Entity e;
+        e.transform.x = pos(rng);
+        e.transform.y = pos(rng);
+        e.collider.w = 16.0f;
+        e.collider.h = 16.0f;
+        if (i % 10 == 0)
+            e.rigidbody.isKinematic = true;
+        else if (i % 3 != 0) // o resto fica parado e pode dormir
+        {
+            e.rigidbody.vx = vel(rng);
+            e.rigidbody.vy = vel(rng);
+        }
+        e.add(ComponentCollider | ComponentRigidBody);
+        scene.createEntity(e);
+    }
+
+    PhysicsSystem physics;
+    physics.reserveSnapshots(rollback + 1, count, count * 4);
+    std::uint32_t frame = 0;
+    for (; frame < 60; ++frame)
+        physics.step(workers, scene, dt);
+
+    double saveMs = 0.0;
+    double restoreMs = 0.0;
+    double resimMs = 0.0;
+    int mismatches = 0;
+    for (int r = 0; r < repeats; ++r)
+    {
+        // rollback frames com snapshot, depois volta ao primeiro
+        std::uint32_t base = frame;
+        for (int k = 0; k < rollback; ++k)
+        {
+            Stopwatch save;
+            if (!physics.saveSnapshot(scene, frame))
+            {
+                std::printf("snapshot full (bodies %d, pairs %d)\n", count, physics.stats().activePairs);
+                return 1;
+            }
+            saveMs += save.elapsedMs();
+            physics.step(workers, scene, dt);
+            frame++;
+        }
+        std::uint64_t expected = StateHash(scene);
+
+        Stopwatch restore;
+        physics.restoreSnapshot(scene, base);
+        restoreMs += restore.elapsedMs();
+
+        Stopwatch resim;
+        for (int k = 0; k < rollback; ++k)
+            physics.step(workers, scene, dt);
+        resimMs += resim.elapsedMs();
+        if (StateHash(scene) != expected)
+            mismatches++;
+    }
+
+    int saves = repeats * rollback;
+    std::printf("bodies %d  snapshot ring %.2f MB  asleep %d\n", count,
+                physics.snapshotBytes() / (1024.0 * 1024.0), physics.stats().sleepingBodies);
+    std::printf("save     %8.2f us/frame\n", saveMs * 1000.0 / saves);
+    std::printf("restore  %8.2f us\n", restoreMs * 1000.0 / repeats);
+    std::printf("resim    %8.2f us/frame (%d frames)\n", resimMs * 1000.0 / saves, rollback);
+    std::printf("deterministic %s (%d/%d mismatches)\n", mismatches == 0 ? "yes" : "NO", mismatches, repeats);
+    return mismatches == 0 ? 0 : 2;
+}
@@ -0,0 +1,105 @@
+// Teste do sono da física: corpos que nascem um pouco dentro de um chão
+// kinematic (e uma pilha em cima dele) se acomodam, dormem uma vez e não
+// acordam mais enquanto o chão não andar. Roda nas três broadphases.
+// Sai com 0 se passou.
+#include "../Engine/ThreadPool.h"
+#include "../Systems/PhysicsSystem.h"
+#include "../World/Scene.h"
+#include <cstdio>
+#include <vector>
+
+static EntityId CreateBox(Scene &scene, float x, float y, float w, float h, bool kinematic)
+{
+    Entity e;
+    e.transform.x = x;
+    e.transform.y = y;
+    e.collider.w = w;
+    e.collider.h = h;
+    e.rigidbody.isKinematic = kinematic;
+    e.add(ComponentCollider | ComponentRigidBody);
+    return scene.createEntity(e);
+}
+
+static bool RunCase(ThreadPool &workers, Broadphase broadphase)
+{
+    const float dt = 1.0f / 60.0f;
+    const float delay = 0.5f;
+    Scene scene;
+    PhysicsSystem physics;
+    physics.setBroadphase(broadphase);
+    physics.setSleepThreshold(5.0f, delay);
+
+    EntityId ground = CreateBox(scene, 0.0f, 200.0f, 600.0f, 20.0f, true);
+    std::vector<EntityId> bodies;
+    bodies.push_back(CreateBox(scene, 40.0f, 172.0f, 30.0f, 30.0f, false)); // 2px dentro do chão
+    for (int i = 0; i < 3; ++i)                                             // pilha sobreposta
+        bodies.push_back(CreateBox(scene, 200.0f, 171.0f - i * 28.0f, 30.0f, 30.0f, false));
+    bodies.push_back(CreateBox(scene, 500.0f, 0.0f, 30.0f, 30.0f, false)); // solto: referência
+
+    std::vector<int> enters(bodies.size(), 0);
+    std::vector<int> exits(bodies.size(), 0);
+    std::vector<int> firstSleep(bodies.size(), -1);
+    std::vector<char> asleep(bodies.size(), 0);
+    int lateEvents = 0; // contato entrando/saindo depois de acomodar
+    for (int step = 0; step < 600; ++step)
+    {
+        physics.step(workers, scene, dt);
+        if (step >= 120)
+            lateEvents += (int)physics.events().size();
+        for (std::size_t i = 0; i < bodies.size(); ++i)
+        {
+            bool now = physics.isSleeping(bodies[i]);
+            if (now && !asleep[i])
+                enters[i]++;
+            if (!now && asleep[i])
+                exits[i]++;
+            if (now && firstSleep[i] < 0)
+                firstSleep[i] = step;
+            asleep[i] = now;
+        }
+    }
+
+    bool ok = true;
+    for (std::size_t i = 0; i < bodies.size(); ++i)
+    {
+        if (enters[i] != 1 || exits[i] != 0 || !asleep[i])
+        {
+            std::printf("broadphase %d body %zu: enters %d exits %d asleep %d\n",
+                        (int)broadphase, i, enters[i], exits[i], (int)asleep[i]);
+            ok = false;
+        }
+    }
+    if (lateEvents != 0)
+    {
+        std::printf("broadphase %d: %d contact events after settling\n", (int)broadphase, lateEvents);
+        ok = false;
+    }
+    // acomodar contra o chão parado não zera o tempo: dorme junto com o solto
+    if (firstSleep[0] != firstSleep.back())
+    {
+        std::printf("broadphase %d: on ground slept at step %d, free body at %d\n",
+                    (int)broadphase, firstSleep[0], firstSleep.back());
+        ok = false;
+    }
+
+    // chão que sobe acorda quem está em cima
+    scene.get<Transform>(ground)->y -= 1.0f;
+    scene.get<WorldTransform>(ground)->y -= 1.0f;
+    physics.step(workers, scene, dt);
+    if (physics.isSleeping(bodies[0]) || !physics.isSleeping(bodies.back()))
+    {
+        std::printf("broadphase %d: moving ground did not wake the body on it\n", (int)broadphase);
+        ok = false;
+    }
+    return ok;
+}
+
+int main()
+{
+    ThreadPool workers;
+    bool ok = true;
+    for (Broadphase broadphase : {Broadphase::Grid, Broadphase::Tree, Broadphase::Sweep})
+        ok = RunCase(workers, broadphase) && ok;
+    std::printf("sleep on kinematic ground: %s\n", ok ? "ok" : "FAILED");
+    return ok ? 0 : 1;
+}
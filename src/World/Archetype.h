@@ -0,0 +1,93 @@
+#pragma once
+#include <memory>
+#include "ChunkedColumn.h"
+#include "Entity.h"
+
+// Todas as entidades com o mesmo conjunto de componentes, em colunas
+// paralelas (SoA). Só as colunas presentes no mask são preenchidas; a linha i
+// de cada coluna pertence à entidade ids[i]. As colunas são paginadas
+// (ChunkedColumn): iterar por chunk dá arrays contíguos de até ChunkRows.
+struct Archetype
+{
+    ComponentMask mask = 0;
+
+    // Componentes de sharedMask não têm coluna: todas as linhas usam o valor
+    // único em shared (dados do prefab). O archetype é por mask + prefab.
+    PrefabHandle prefab = InvalidPrefab;
+    ComponentMask sharedMask = 0;
+    std::shared_ptr<const Entity> shared;
+
+    ChunkedColumn<EntityId> ids;
+    ChunkedColumn<Transform> transforms;
+    ChunkedColumn<RectRender> rects;
+    ChunkedColumn<SpriteRender> sprites;
+    ChunkedColumn<ColliderAABB> colliders;
+    ChunkedColumn<RigidBody2D> rigidbodies;
+    ChunkedColumn<WorldTransform> worlds;
+    ChunkedColumn<Parent> parents;
+
+    // Tick da última escrita de cada linha, por tipo de componente (índice
+    // ComponentTraits<T>::index). Só os tipos presentes no mask são usados.
+    ChunkedColumn<std::uint32_t> changeTicks[ComponentTypeCount];
+
+    std::size_t size() const { return ids.size(); }
+    int chunkCount() const { return ids.chunkCount(); }
+    int chunkRows(int chunk) const { return ids.chunkRows(chunk); }
+    bool has(ComponentMask bits) const { return (mask & bits) == bits; }
+    // Tem coluna própria (presente e não compartilhado).
+    bool owns(ComponentMask bits) const { return has(bits) && (sharedMask & bits) == 0; }
+    // Passo para indexar o chunk de T: 0 se compartilhado (um valor só).
+    template <typename T>
+    int step() const { return (sharedMask & ComponentTraits<T>::bit) ? 0 : 1; }
+
+    template <typename T>
+    ChunkedColumn<std::uint32_t> &ticks() { return changeTicks[ComponentTraits<T>::index]; }
+    template <typename T>
+    const ChunkedColumn<std::uint32_t> &ticks() const { return changeTicks[ComponentTraits<T>::index]; }
+
+    // Carimba tick nas colunas de bits (que existam) da linha row.
+    void markChanged(ComponentMask bits, std::size_t row, std::uint32_t tick)
+    {
+        bits &= mask;
+        for (int i = 0; i < ComponentTypeCount; ++i)
+        {
+            if (bits & (1u << i))
+                changeTicks[i][row] = tick;
+        }
+    }
+
+    // Alguma das colunas de bits foi escrita depois de since?
+    bool changedSince(ComponentMask bits, std::size_t row, std::uint32_t since) const
+    {
+        bits &= mask;
+        for (int i = 0; i < ComponentTypeCount; ++i)
+        {
+            if ((bits & (1u << i)) && changeTicks[i][row] > since)
+                return true;
+        }
+        return false;
+    }
+
+    template <typename T>
+    ChunkedColumn<T> &column();
+    template <typename T>
+    const ChunkedColumn<T> &column() const
+    {
+        return const_cast<Archetype *>(this)->column<T>();
+    }
+};
+
+template <>
+inline ChunkedColumn<Transform> &Archetype::column<Transform>() { return transforms; }
+template <>
+inline ChunkedColumn<RectRender> &Archetype::column<RectRender>() { return rects; }
+template <>
+inline ChunkedColumn<SpriteRender> &Archetype::column<SpriteRender>() { return sprites; }
+template <>
+inline ChunkedColumn<ColliderAABB> &Archetype::column<ColliderAABB>() { return colliders; }
+template <>
+inline ChunkedColumn<RigidBody2D> &Archetype::column<RigidBody2D>() { return rigidbodies; }
+template <>
+inline ChunkedColumn<WorldTransform> &Archetype::column<WorldTransform>() { return worlds; }
+template <>
+inline ChunkedColumn<Parent> &Archetype::column<Parent>() { return parents; }
@@ -0,0 +1,137 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Linhas por página. Todas as colunas de um archetype usam o mesmo valor,
+// então o chunk c de cada coluna cobre as mesmas linhas.
+constexpr int ChunkShift = 10;
+constexpr int ChunkRows = 1 << ChunkShift;
+constexpr int ChunkMask = ChunkRows - 1;
+
+// Coluna em páginas de tamanho fixo. Crescer só aloca páginas novas: nenhum
+// elemento existente é copiado ou movido, então ponteiros para componentes
+// continuam válidos quando outras entidades são criadas. Páginas esvaziadas
+// vão para uma lista livre e são reaproveitadas antes de alocar outra.
+template <typename T>
+class ChunkedColumn
+{
+public:
+    static_assert(alignof(T) <= alignof(std::max_align_t), "ChunkedColumn: over-aligned type");
+
+    ChunkedColumn() = default;
+    ~ChunkedColumn() { release(); }
+
+    ChunkedColumn(const ChunkedColumn &) = delete;
+    ChunkedColumn &operator=(const ChunkedColumn &) = delete;
+
+    ChunkedColumn(ChunkedColumn &&other) noexcept
+        : pages_(std::move(other.pages_)), free_(std::move(other.free_)), size_(other.size_)
+    {
+        other.pages_.clear();
+        other.free_.clear();
+        other.size_ = 0;
+    }
+
+    ChunkedColumn &operator=(ChunkedColumn &&other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            pages_ = std::move(other.pages_);
+            free_ = std::move(other.free_);
+            size_ = other.size_;
+            other.pages_.clear();
+            other.free_.clear();
+            other.size_ = 0;
+        }
+        return *this;
+    }
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    T &operator[](std::size_t i) { return pages_[i >> ChunkShift][i & ChunkMask]; }
+    const T &operator[](std::size_t i) const { return pages_[i >> ChunkShift][i & ChunkMask]; }
+    T &back() { return (*this)[size_ - 1]; }
+
+    int chunkCount() const { return (int)((size_ + ChunkMask) >> ChunkShift); }
+    int chunkRows(int chunk) const
+    {
+        std::size_t begin = (std::size_t)chunk << ChunkShift;
+        std::size_t rows = size_ - begin;
+        return rows > (std::size_t)ChunkRows ? ChunkRows : (int)rows;
+    }
+    T *chunk(int c) { return pages_[c]; }
+    const T *chunk(int c) const { return pages_[c]; }
+
+    template <typename... Args>
+    T &emplace_back(Args &&...args)
+    {
+        std::size_t page = size_ >> ChunkShift;
+        if (page == pages_.size())
+            pages_.push_back(acquirePage());
+        T *slot = pages_[page] + (size_ & ChunkMask);
+        new (slot) T(std::forward<Args>(args)...);
+        size_++;
+        return *slot;
+    }
+
+    void push_back(const T &value) { emplace_back(value); }
+    void push_back(T &&value) { emplace_back(std::move(value)); }
+
+    void pop_back()
+    {
+        size_--;
+        (*this)[size_].~T();
+        if ((size_ & ChunkMask) == 0)
+        {
+            free_.push_back(pages_.back());
+            pages_.pop_back();
+        }
+    }
+
+    // Garante páginas para n linhas de uma vez (spawn em massa).
+    void reserve(std::size_t n)
+    {
+        std::size_t pages = (n + ChunkMask) >> ChunkShift;
+        std::size_t have = pages_.size() + free_.size();
+        for (; have < pages; ++have)
+            free_.push_back(allocatePage());
+    }
+
+    void clear()
+    {
+        while (size_ > 0)
+            pop_back();
+    }
+
+private:
+    static T *allocatePage()
+    {
+        return static_cast<T *>(::operator new(sizeof(T) * ChunkRows));
+    }
+
+    void release()
+    {
+        clear();
+        for (T *page : free_)
+            ::operator delete(page);
+        free_.clear();
+    }
+
+    T *acquirePage()
+    {
+        if (free_.empty())
+            return allocatePage();
+        T *page = free_.back();
+        free_.pop_back();
+        return page;
+    }
+
+private:
+    std::vector<T *> pages_;
+    std::vector<T *> free_;
+    std::size_t size_ = 0;
+};
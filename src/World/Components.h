@@ -1,23 +1,132 @@
 #pragma once
+#include <cstdint>
+#include "../Assets/TextureHandle.h"
 
+// Componentes são dados puros. Cada um vira uma coluna (SoA) dentro do
+// Archetype; ter ou não o componente é o que antes era o flag "enabled".
+
+// Posição local: relativa ao pai (Parent) ou ao mundo, se não houver pai.
 struct Transform
 {
     float x = 0.0f;
     float y = 0.0f;
 };
 
+// Posição no mundo, calculada pelo TransformSystem (cache). Toda entidade
+// tem; physics e render leem daqui.
+struct WorldTransform
+{
+    float x = 0.0f;
+    float y = 0.0f;
+};
+
+// Pai na hierarquia (EntityId). Use Scene::setParent para mudar.
+struct Parent
+{
+    std::uint32_t id = 0;
+};
+
 struct RectRender
 {
     int w = 32;
     int h = 32;
-    unsigned char r = 255;
-    unsigned char g = 255;
-    unsigned char b = 255;
-    unsigned char a = 255;
+    unsigned char r = 255, g = 255, b = 255, a = 255;
+    int layer = 0;
+};
+
+struct SpriteRender
+{
+    TextureHandle texture = InvalidTexture; // resolvido pelo AssetManager
+    float scale = 1.0f;
+    float rotationDeg = 0.0f;
+    int layer = 0;
+};
+
+struct ColliderAABB
+{
+    float w = 32.0f;
+    float h = 32.0f;
+    float offsetX = 0.0f;
+    float offsetY = 0.0f;
+    bool isTrigger = false;
+    std::uint32_t layerMask = 0xFFFFFFFFu;
 };
 
-struct Velocity
+struct RigidBody2D
 {
-    float vx = 0.0f; // pixels/segundo
+    float vx = 0.0f;
     float vy = 0.0f;
+    bool isKinematic = false;
+};
+
+using ComponentMask = std::uint32_t;
+
+enum ComponentBit : ComponentMask
+{
+    ComponentTransform = 1u << 0,
+    ComponentRect = 1u << 1,
+    ComponentSprite = 1u << 2,
+    ComponentCollider = 1u << 3,
+    ComponentRigidBody = 1u << 4,
+    ComponentWorldTransform = 1u << 5,
+    ComponentParent = 1u << 6
+};
+
+constexpr int ComponentTypeCount = 7;
+
+// Presentes em todo archetype.
+constexpr ComponentMask ComponentBase = ComponentTransform | ComponentWorldTransform;
+// Podem ser compartilhados entre instâncias de um prefab (dados imutáveis).
+constexpr ComponentMask ComponentShareable = ComponentRect | ComponentSprite | ComponentCollider;
+
+template <typename T>
+struct ComponentTraits;
+
+template <>
+struct ComponentTraits<Transform>
+{
+    static constexpr ComponentMask bit = ComponentTransform;
+    static constexpr int index = 0;
+};
+
+template <>
+struct ComponentTraits<RectRender>
+{
+    static constexpr ComponentMask bit = ComponentRect;
+    static constexpr int index = 1;
+};
+
+template <>
+struct ComponentTraits<SpriteRender>
+{
+    static constexpr ComponentMask bit = ComponentSprite;
+    static constexpr int index = 2;
+};
+
+template <>
+struct ComponentTraits<ColliderAABB>
+{
+    static constexpr ComponentMask bit = ComponentCollider;
+    static constexpr int index = 3;
+};
+
+template <>
+struct ComponentTraits<RigidBody2D>
+{
+    static constexpr ComponentMask bit = ComponentRigidBody;
+    static constexpr int index = 4;
+};
+
+template <>
+struct ComponentTraits<WorldTransform>
+{
+    static constexpr ComponentMask bit = ComponentWorldTransform;
+    static constexpr int index = 5;
+};
+
+template <>
+struct ComponentTraits<Parent>
+{
+    static constexpr ComponentMask bit = ComponentParent;
+    static constexpr int index = 6;
 };
@@ -1,60 +1,69 @@
 #pragma once
-#include <memory>
 #include <cstdint>
+#include "Components.h"
 
-struct Transform
-{
-    float x = 0.0f;
-    float y = 0.0f;
-};
-
-struct RectRender
-{
-    int w = 32;
-    int h = 32;
-    unsigned char r = 255, g = 255, b = 255, a = 255;
-    bool enabled = true; // debug/fallback
-};
-
-class Texture;
+// Handle de 32 bits: índice do slot (bits baixos) + geração (bits altos).
+// Um handle de entidade destruída não bate mais com a geração do slot, então
+// nunca aponta para a entidade que reaproveitou o índice. 0 = nenhuma.
+using EntityId = std::uint32_t;
 
-struct SpriteRender
-{
-    std::shared_ptr<Texture> texture;
-    float scale = 1.0f;
-    float rotationDeg = 0.0f;
-    bool enabled = false;
-};
+constexpr EntityId InvalidEntity = 0;
+constexpr int EntityIndexBits = 20;
+constexpr std::uint32_t EntityIndexMask = (1u << EntityIndexBits) - 1u;
+constexpr std::uint32_t EntityGenerationMask = (1u << (32 - EntityIndexBits)) - 1u;
 
-struct ColliderAABB
+inline std::uint32_t EntityIndex(EntityId id) { return id & EntityIndexMask; }
+inline std::uint32_t EntityGeneration(EntityId id) { return id >> EntityIndexBits; }
+inline EntityId MakeEntityId(std::uint32_t index, std::uint32_t generation)
 {
-    float w = 32.0f;
-    float h = 32.0f;
-    float offsetX = 0.0f;
-    float offsetY = 0.0f;
-    bool isTrigger = false;
-    bool enabled = false;
-    std::uint32_t layerMask = 0xFFFFFFFFu;
-};
+    return (generation << EntityIndexBits) | (index & EntityIndexMask);
+}
 
-struct RigidBody2D
-{
-    float vx = 0.0f;
-    float vy = 0.0f;
-    bool isKinematic = false;
-    bool enabled = false;
-};
+// Prefab registrado no Scene (Scene::createPrefab). 0 = nenhum.
+using PrefabHandle = std::uint32_t;
+constexpr PrefabHandle InvalidPrefab = 0;
 
+// Forma "gorda" de uma entidade, usada só para criar, inspecionar e salvar.
+// O Scene não guarda Entity: os componentes ficam em colunas por archetype.
 struct Entity
 {
-    int id = 0;
-    bool isSolid = true;
-
-    int renderLayer = 0;
+    EntityId id = InvalidEntity;
+    ComponentMask components = ComponentBase;
 
     Transform transform;
     RectRender rect;
     SpriteRender sprite;
     ColliderAABB collider;
     RigidBody2D rigidbody;
+    Parent parent;
+
+    // Instância de prefab: bits em shared são lidos dos dados do prefab em
+    // vez de uma cópia própria (ver Scene::createPrefab).
+    PrefabHandle prefab = InvalidPrefab;
+    ComponentMask shared = 0;
+
+    bool has(ComponentMask bits) const { return (components & bits) == bits; }
+    void add(ComponentMask bits) { components |= bits; }
+    void remove(ComponentMask bits) { components = (components & ~bits) | ComponentBase; }
+
+    template <typename T>
+    T &component();
+    template <typename T>
+    const T &component() const
+    {
+        return const_cast<Entity *>(this)->component<T>();
+    }
 };
+
+template <>
+inline Transform &Entity::component<Transform>() { return transform; }
+template <>
+inline RectRender &Entity::component<RectRender>() { return rect; }
+template <>
+inline SpriteRender &Entity::component<SpriteRender>() { return sprite; }
+template <>
+inline ColliderAABB &Entity::component<ColliderAABB>() { return collider; }
+template <>
+inline RigidBody2D &Entity::component<RigidBody2D>() { return rigidbody; }
+template <>
+inline Parent &Entity::component<Parent>() { return parent; }
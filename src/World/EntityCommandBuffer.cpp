@@ -0,0 +1,112 @@
+#include "EntityCommandBuffer.h"
+#include <unordered_map>
+#include "Scene.h"
+
+EntityCommandBuffer::Command &EntityCommandBuffer::push(CommandType type, EntityId id)
+{
+    commands_.emplace_back();
+    Command &cmd = commands_.back();
+    cmd.type = type;
+    cmd.id = id;
+    return cmd;
+}
+
+EntityId EntityCommandBuffer::create(const Entity &desc)
+{
+    EntityId id = scene_->reserveEntity();
+    if (id == InvalidEntity)
+        return InvalidEntity;
+    Command &cmd = push(CommandType::Create, id);
+    cmd.desc = desc;
+    return id;
+}
+
+void EntityCommandBuffer::destroy(EntityId id)
+{
+    push(CommandType::Destroy, id);
+}
+
+void EntityCommandBuffer::remove(EntityId id, ComponentMask bits)
+{
+    Command &cmd = push(CommandType::Remove, id);
+    cmd.desc.components = bits;
+}
+
+// Copia para dst só os componentes marcados em bits.
+static void CopyComponents(Entity &dst, const Entity &src, ComponentMask bits)
+{
+    if (bits & ComponentTransform)
+        dst.transform = src.transform;
+    if (bits & ComponentRect)
+        dst.rect = src.rect;
+    if (bits & ComponentSprite)
+        dst.sprite = src.sprite;
+    if (bits & ComponentCollider)
+        dst.collider = src.collider;
+    if (bits & ComponentRigidBody)
+        dst.rigidbody = src.rigidbody;
+    if (bits & ComponentParent)
+        dst.parent = src.parent;
+}
+
+void EntityCommandBuffer::clear()
+{
+    for (const Command &cmd : commands_)
+    {
+        if (cmd.type == CommandType::Create)
+            scene_->releaseEntity(cmd.id);
+    }
+    commands_.clear();
+}
+
+void EntityCommandBuffer::playback()
+{
+    if (commands_.empty())
+        return;
+    Scene &scene = *scene_;
+
+    // Reserva uma vez por archetype (mask + prefab) para o lote inteiro de
+    // criações
+    std::unordered_map<std::uint64_t, std::pair<const Entity *, std::size_t>> creates;
+    for (const Command &cmd : commands_)
+    {
+        if (cmd.type != CommandType::Create)
+            continue;
+        std::uint64_t key = ((std::uint64_t)cmd.desc.prefab << 32) | cmd.desc.components;
+        auto &entry = creates[key];
+        entry.first = &cmd.desc;
+        entry.second++;
+    }
+    for (const auto &it : creates)
+        scene.reserve(*it.second.first, it.second.second);
+
+    Entity e;
+    for (const Command &cmd : commands_)
+    {
+        switch (cmd.type)
+        {
+        case CommandType::Create:
+            scene.createEntity(cmd.id, cmd.desc);
+            break;
+        case CommandType::Destroy:
+            scene.destroyEntity(cmd.id);
+            break;
+        case CommandType::Add:
+            // entidade pode ter sido destruída antes no mesmo lote
+            if (!scene.readEntity(cmd.id, e))
+                break;
+            CopyComponents(e, cmd.desc, cmd.desc.components);
+            e.add(cmd.desc.components);
+            scene.writeEntity(e);
+            break;
+        case CommandType::Remove:
+            if (!scene.readEntity(cmd.id, e))
+                break;
+            e.remove(cmd.desc.components);
+            scene.writeEntity(e);
+            break;
+        }
+    }
+
+    commands_.clear();
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <vector>
+#include "Entity.h"
+
+class Scene;
+
+// Mudanças estruturais adiadas (criar/destruir/adicionar componente).
+// Callbacks e sistemas gravam aqui enquanto o Scene está sendo iterado; o
+// Engine aplica tudo de uma vez em um ponto de sincronização do tick.
+class EntityCommandBuffer
+{
+public:
+    explicit EntityCommandBuffer(Scene &scene) : scene_(&scene) {}
+    ~EntityCommandBuffer() { clear(); }
+    EntityCommandBuffer(const EntityCommandBuffer &) = delete;
+    EntityCommandBuffer &operator=(const EntityCommandBuffer &) = delete;
+
+    // O id já vale na gravação (reservado no Scene): o mesmo lote pode
+    // adicionar componentes, usar como Parent ou destruir. Só fica vivo no
+    // playback.
+    EntityId create(const Entity &desc);
+    void destroy(EntityId id);
+    void remove(EntityId id, ComponentMask bits);
+
+    template <typename T>
+    void add(EntityId id, const T &value)
+    {
+        Command &cmd = push(CommandType::Add, id);
+        cmd.desc.components = ComponentTraits<T>::bit;
+        cmd.desc.component<T>() = value;
+    }
+
+    // Aplica os comandos na ordem em que foram gravados e esvazia o buffer.
+    void playback();
+    // Descarta os comandos e devolve os ids reservados por create.
+    void clear();
+
+    bool empty() const { return commands_.empty(); }
+    std::size_t size() const { return commands_.size(); }
+
+private:
+    enum class CommandType
+    {
+        Create,
+        Destroy,
+        Add,
+        Remove
+    };
+
+    struct Command
+    {
+        CommandType type = CommandType::Create;
+        EntityId id = InvalidEntity;
+        Entity desc; // Create: entidade inteira; Add: só os bits/valores novos
+    };
+
+    Command &push(CommandType type, EntityId id);
+
+private:
+    Scene *scene_;
+    std::vector<Command> commands_;
+};
@@ -1,4 +1,5 @@
 #pragma once
+#include "Entity.h"
 
 class Engine;
 
@@ -13,7 +14,10 @@ public:
     virtual void onFixedUpdate(Engine &engine, float fixedDt) {}
     virtual void onRenderUI(Engine &engine) {}
 
-    virtual void onCollisionEnter(Engine &engine, int aId, int bId) {}
-    virtual void onCollisionStay(Engine &engine, int aId, int bId) {}
-    virtual void onCollisionExit(Engine &engine, int aId, int bId) {}
+    // Chamados depois do step (dispatchEvents), um por evento. Crie/destrua
+    // entidades via engine.commands(): os eventos seguintes ainda citam os
+    // ids deste step, e o playback roda logo depois do último callback.
+    virtual void onCollisionEnter(Engine &engine, EntityId aId, EntityId bId) {}
+    virtual void onCollisionStay(Engine &engine, EntityId aId, EntityId bId) {}
+    virtual void onCollisionExit(Engine &engine, EntityId aId, EntityId bId) {}
 };
@@ -1,21 +1,554 @@
 #include "Scene.h"
+#include <algorithm>
+#include <cstdio>
 
-Entity &Scene::createEntity()
+EntityId Scene::createEntity()
+{
+    return createEntity(Entity{});
+}
+
+EntityId Scene::createEntity(const Entity &desc)
+{
+    return createEntity(reserveEntity(), desc);
+}
+
+EntityId Scene::reserveEntity()
+{
+    if (slots_.empty())
+        slots_.resize(1); // índice 0 nunca é usado: id 0 = InvalidEntity
+
+    std::uint32_t index = freeHead_;
+    if (index != 0)
+    {
+        freeHead_ = slots_[index].nextFree;
+        if (freeHead_ == 0)
+            freeTail_ = 0;
+    }
+    else
+    {
+        if (slots_.size() > EntityIndexMask)
+        {
+            std::printf("Scene: entity limit reached (%u)\n", EntityIndexMask);
+            return InvalidEntity;
+        }
+        index = (std::uint32_t)slots_.size();
+        slots_.push_back(EntitySlot{});
+    }
+
+    slots_[index].reserved = true;
+    return MakeEntityId(index, slots_[index].generation);
+}
+
+EntityId Scene::createEntity(EntityId reserved, const Entity &desc)
+{
+    std::uint32_t index = EntityIndex(reserved);
+    if (index == 0 || index >= slots_.size() || !slots_[index].reserved ||
+        slots_[index].generation != EntityGeneration(reserved))
+        return InvalidEntity;
+
+    slots_[index].reserved = false;
+    insertRow(reserved, desc);
+    entityCount_++;
+    return reserved;
+}
+
+void Scene::releaseEntity(EntityId reserved)
+{
+    std::uint32_t index = EntityIndex(reserved);
+    if (index == 0 || index >= slots_.size() || !slots_[index].reserved ||
+        slots_[index].generation != EntityGeneration(reserved))
+        return;
+    slots_[index].reserved = false;
+    freeSlot(index);
+}
+
+bool Scene::destroyEntity(EntityId id)
+{
+    const EntitySlot *loc = locate(id);
+    if (!loc)
+        return false;
+    // filhos da entidade viram raízes: a ordem do TransformSystem muda
+    if (hasHierarchy())
+        hierarchyVersion_++;
+    removeRow(*loc);
+    freeSlot(EntityIndex(id));
+    entityCount_--;
+    return true;
+}
+
+// Nova geração (ids antigos deixam de valer) e fim da fila livre.
+void Scene::freeSlot(std::uint32_t index)
+{
+    EntitySlot &slot = slots_[index];
+    slot.archetype = -1;
+    slot.row = -1;
+    slot.generation = (slot.generation + 1) & EntityGenerationMask;
+    slot.nextFree = 0;
+    if (freeTail_ != 0)
+        slots_[freeTail_].nextFree = index;
+    else
+        freeHead_ = index;
+    freeTail_ = index;
+}
+
+void Scene::reserve(ComponentMask mask, std::size_t count)
+{
+    Entity desc;
+    desc.components = mask;
+    reserve(desc, count);
+}
+
+void Scene::reserve(const Entity &desc, std::size_t count)
+{
+    if (count == 0)
+        return;
+
+    // crescimento geométrico: reservas pequenas a cada frame não viram realloc
+    std::size_t needed = slots_.size() + count;
+    if (needed > slots_.capacity())
+        slots_.reserve(std::max(needed, slots_.capacity() * 2));
+
+    reserveRows(archetypes_[archetypeFor(desc.components, desc.prefab, sharedMaskFor(desc))], count);
+}
+
+void Scene::reserveRows(Archetype &arch, std::size_t count)
+{
+    std::size_t rows = arch.size() + count;
+    arch.ids.reserve(rows);
+    arch.transforms.reserve(rows);
+    arch.worlds.reserve(rows);
+    if (arch.owns(ComponentRect))
+        arch.rects.reserve(rows);
+    if (arch.owns(ComponentSprite))
+        arch.sprites.reserve(rows);
+    if (arch.owns(ComponentCollider))
+        arch.colliders.reserve(rows);
+    if (arch.has(ComponentRigidBody))
+        arch.rigidbodies.reserve(rows);
+    if (arch.has(ComponentParent))
+        arch.parents.reserve(rows);
+    for (int i = 0; i < ComponentTypeCount; ++i)
+    {
+        if (arch.mask & (1u << i))
+            arch.changeTicks[i].reserve(rows);
+    }
+}
+
+bool Scene::isAlive(EntityId id) const
+{
+    return locate(id) != nullptr;
+}
+
+const Scene::EntitySlot *Scene::locate(EntityId id) const
+{
+    std::uint32_t index = EntityIndex(id);
+    if (index == 0 || index >= slots_.size())
+        return nullptr;
+    const EntitySlot &slot = slots_[index];
+    if (slot.archetype < 0 || slot.generation != EntityGeneration(id))
+        return nullptr;
+    return &slot;
+}
+
+Archetype *Scene::archetypeOf(EntityId id, int &row)
+{
+    const EntitySlot *loc = locate(id);
+    if (!loc)
+        return nullptr;
+    row = loc->row;
+    return &archetypes_[loc->archetype];
+}
+
+const Archetype *Scene::archetypeOf(EntityId id, int &row) const
+{
+    return const_cast<Scene *>(this)->archetypeOf(id, row);
+}
+
+EntityId Scene::parentOf(EntityId id) const
+{
+    const Parent *p = get<Parent>(id);
+    if (!p || !isAlive(p->id))
+        return InvalidEntity;
+    return p->id;
+}
+
+bool Scene::setParent(EntityId child, EntityId parent)
+{
+    if (!isAlive(child))
+        return false;
+
+    if (parent != InvalidEntity)
+    {
+        if (!isAlive(parent))
+            return false;
+        // sobe a partir do novo pai: se passar pelo filho, fecharia um ciclo
+        for (EntityId p = parent; p != InvalidEntity; p = parentOf(p))
+        {
+            if (p == child)
+            {
+                std::printf("Scene: setParent would create a cycle (%u -> %u)\n", child, parent);
+                return false;
+            }
+        }
+    }
+
+    int row = 0;
+    Archetype *arch = archetypeOf(child, row);
+    if (arch->has(ComponentParent))
+    {
+        if (parent == InvalidEntity)
+        {
+            Entity e;
+            readEntity(child, e);
+            e.remove(ComponentParent);
+            writeEntity(e);
+        }
+        else
+        {
+            arch->parents[row].id = parent;
+            arch->ticks<Parent>()[row] = changeTick_;
+            writeVersion_++;
+        }
+    }
+    else if (parent != InvalidEntity)
+    {
+        Entity e;
+        readEntity(child, e);
+        e.add(ComponentParent);
+        e.parent.id = parent;
+        writeEntity(e);
+    }
+    hierarchyVersion_++;
+    return true;
+}
+
+bool Scene::hasHierarchy() const
+{
+    for (const auto &arch : archetypes_)
+    {
+        if (arch.has(ComponentParent) && arch.size() > 0)
+            return true;
+    }
+    return false;
+}
+
+static_assert(ComponentTypeCount <= 16, "archetype key packs two masks in 32 bits");
+
+int Scene::archetypeFor(ComponentMask mask, PrefabHandle prefab, ComponentMask shared)
+{
+    mask |= ComponentBase;
+    shared &= mask;
+    if (shared == 0)
+        prefab = InvalidPrefab;
+    std::uint64_t key = ((std::uint64_t)prefab << 32) | ((std::uint64_t)shared << 16) | mask;
+    auto it = archetypeByKey_.find(key);
+    if (it != archetypeByKey_.end())
+        return it->second;
+
+    Archetype arch;
+    arch.mask = mask;
+    arch.prefab = prefab;
+    arch.sharedMask = shared;
+    if (prefab != InvalidPrefab)
+        arch.shared = prefabs_[prefab - 1].data;
+    archetypes_.push_back(std::move(arch));
+    int index = (int)archetypes_.size() - 1;
+    archetypeByKey_[key] = index;
+    return index;
+}
+
+static bool Same(const RectRender &a, const RectRender &b)
+{
+    return a.w == b.w && a.h == b.h && a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a &&
+           a.layer == b.layer;
+}
+
+static bool Same(const SpriteRender &a, const SpriteRender &b)
+{
+    return a.texture == b.texture && a.scale == b.scale && a.rotationDeg == b.rotationDeg &&
+           a.layer == b.layer;
+}
+
+static bool Same(const ColliderAABB &a, const ColliderAABB &b)
+{
+    return a.w == b.w && a.h == b.h && a.offsetX == b.offsetX && a.offsetY == b.offsetY &&
+           a.isTrigger == b.isTrigger && a.layerMask == b.layerMask;
+}
+
+// Bits que continuam compartilhados: pedidos em desc.shared, permitidos pelo
+// prefab e com o mesmo valor dos dados dele (valor diferente = cópia própria).
+ComponentMask Scene::sharedMaskFor(const Entity &desc) const
+{
+    if (desc.prefab == InvalidPrefab || desc.prefab > prefabs_.size())
+        return 0;
+    const PrefabSlot &slot = prefabs_[desc.prefab - 1];
+    ComponentMask shared = desc.shared & slot.shared & desc.components;
+    if ((shared & ComponentRect) && !Same(desc.rect, slot.data->rect))
+        shared &= ~ComponentRect;
+    if ((shared & ComponentSprite) && !Same(desc.sprite, slot.data->sprite))
+        shared &= ~ComponentSprite;
+    if ((shared & ComponentCollider) && !Same(desc.collider, slot.data->collider))
+        shared &= ~ComponentCollider;
+    return shared;
+}
+
+bool Scene::detachShared(EntityId id, ComponentMask bits)
 {
     Entity e;
-    e.id = nextEntityId_++;
-    entities_.push_back(e);
-    return entities_.back();
+    if (!readEntity(id, e))
+        return false;
+    e.shared &= ~bits;
+    return writeEntity(e);
+}
+
+PrefabHandle Scene::createPrefab(const std::string &name, const Entity &desc, ComponentMask shared)
+{
+    PrefabSlot slot;
+    slot.name = name;
+    auto data = std::make_shared<Entity>(desc);
+    data->id = InvalidEntity;
+    data->prefab = (PrefabHandle)prefabs_.size() + 1;
+    data->shared = shared & ComponentShareable & desc.components;
+    slot.shared = data->shared;
+    slot.data = std::move(data);
+    prefabs_.push_back(std::move(slot));
+    return (PrefabHandle)prefabs_.size();
+}
+
+PrefabHandle Scene::findPrefab(const std::string &name) const
+{
+    for (std::size_t i = 0; i < prefabs_.size(); ++i)
+    {
+        if (prefabs_[i].name == name)
+            return (PrefabHandle)i + 1;
+    }
+    return InvalidPrefab;
+}
+
+Entity Scene::prefabEntity(PrefabHandle prefab) const
+{
+    if (prefab == InvalidPrefab || prefab > prefabs_.size())
+        return Entity{};
+    return *prefabs_[prefab - 1].data;
+}
+
+bool Scene::updatePrefab(PrefabHandle prefab, const Entity &desc)
+{
+    if (prefab == InvalidPrefab || prefab > prefabs_.size())
+        return false;
+    PrefabSlot &slot = prefabs_[prefab - 1];
+    auto data = std::make_shared<Entity>(desc);
+    data->id = InvalidEntity;
+    data->prefab = prefab;
+    data->components = slot.data->components; // o conjunto não muda: só os valores
+    data->shared = slot.shared;
+    slot.data = std::move(data);
+
+    for (auto &arch : archetypes_)
+    {
+        if (arch.prefab != prefab)
+            continue;
+        arch.shared = slot.data;
+        for (std::size_t row = 0; row < arch.size(); ++row)
+            arch.markChanged(arch.sharedMask, row, changeTick_);
+    }
+    writeVersion_++;
+    return true;
+}
+
+std::size_t Scene::instantiate(PrefabHandle prefab, std::size_t count,
+                               const Transform *positions, EntityId *outIds)
+{
+    if (prefab == InvalidPrefab || prefab > prefabs_.size() || count == 0)
+        return 0;
+
+    Entity desc = *prefabs_[prefab - 1].data;
+    reserve(desc, count);
+
+    std::size_t created = 0;
+    for (; created < count; ++created)
+    {
+        if (positions)
+            desc.transform = positions[created];
+        EntityId id = createEntity(desc);
+        if (id == InvalidEntity)
+            break;
+        if (outIds)
+            outIds[created] = id;
+    }
+    return created;
+}
+
+void Scene::insertRow(EntityId id, const Entity &desc)
+{
+    ComponentMask shared = sharedMaskFor(desc);
+    int index = archetypeFor(desc.components, desc.prefab, shared);
+    Archetype &arch = archetypes_[index];
+
+    EntitySlot &loc = slots_[EntityIndex(id)];
+    loc.archetype = index;
+    loc.row = (int)arch.size();
+
+    // world inicial: local, ou local + world do pai (o TransformSystem
+    // corrige no próximo update se o pai ainda estiver desatualizado)
+    WorldTransform world{desc.transform.x, desc.transform.y};
+    if (desc.has(ComponentParent) && desc.parent.id != id)
+    {
+        const Scene &self = *this;
+        if (const WorldTransform *pw = self.get<WorldTransform>(desc.parent.id))
+        {
+            world.x += pw->x;
+            world.y += pw->y;
+        }
+        hierarchyVersion_++;
+    }
+
+    arch.ids.push_back(id);
+    arch.transforms.push_back(desc.transform);
+    arch.worlds.push_back(world);
+    if (arch.owns(ComponentRect))
+        arch.rects.push_back(desc.rect);
+    if (arch.owns(ComponentSprite))
+        arch.sprites.push_back(desc.sprite);
+    if (arch.owns(ComponentCollider))
+        arch.colliders.push_back(desc.collider);
+    if (arch.has(ComponentRigidBody))
+        arch.rigidbodies.push_back(desc.rigidbody);
+    if (arch.has(ComponentParent))
+        arch.parents.push_back(desc.parent);
+    for (int i = 0; i < ComponentTypeCount; ++i)
+    {
+        if (arch.mask & (1u << i))
+            arch.changeTicks[i].push_back(changeTick_);
+    }
+    structureVersion_++;
+    writeVersion_++;
+}
+
+template <typename T>
+static void SwapRemove(ChunkedColumn<T> &column, int row)
+{
+    if (column.empty())
+        return;
+    if (row != (int)column.size() - 1)
+        column[row] = std::move(column.back());
+    column.pop_back();
+}
+
+void Scene::removeRow(const EntitySlot &loc)
+{
+    Archetype &arch = archetypes_[loc.archetype];
+    int row = loc.row;
+    int last = (int)arch.size() - 1;
+
+    // swap-remove: a última linha ocupa o buraco, então só ela muda de lugar
+    if (row != last)
+        slots_[EntityIndex(arch.ids[last])].row = row;
+
+    SwapRemove(arch.ids, row);
+    SwapRemove(arch.transforms, row);
+    SwapRemove(arch.rects, row);
+    SwapRemove(arch.sprites, row);
+    SwapRemove(arch.colliders, row);
+    SwapRemove(arch.rigidbodies, row);
+    SwapRemove(arch.worlds, row);
+    SwapRemove(arch.parents, row);
+    for (auto &ticks : arch.changeTicks)
+        SwapRemove(ticks, row);
+    structureVersion_++;
+    writeVersion_++;
+}
+
+bool Scene::readEntity(EntityId id, Entity &out) const
+{
+    const EntitySlot *loc = locate(id);
+    if (!loc)
+        return false;
+
+    const Archetype &arch = archetypes_[loc->archetype];
+    int row = loc->row;
+
+    out = Entity{};
+    out.id = id;
+    out.components = arch.mask;
+    out.transform = arch.transforms[row];
+    if (arch.shared)
+    {
+        out.prefab = arch.prefab;
+        out.shared = arch.sharedMask;
+        out.rect = arch.shared->rect;
+        out.sprite = arch.shared->sprite;
+        out.collider = arch.shared->collider;
+    }
+    if (arch.owns(ComponentRect))
+        out.rect = arch.rects[row];
+    if (arch.owns(ComponentSprite))
+        out.sprite = arch.sprites[row];
+    if (arch.owns(ComponentCollider))
+        out.collider = arch.colliders[row];
+    if (arch.has(ComponentRigidBody))
+        out.rigidbody = arch.rigidbodies[row];
+    if (arch.has(ComponentParent))
+        out.parent = arch.parents[row];
+    return true;
 }
 
-Entity *Scene::findEntity(int id)
+bool Scene::writeEntity(const Entity &e)
 {
-    for (auto &e : entities_)
+    const EntitySlot *loc = locate(e.id);
+    if (!loc)
+        return false;
+
+    Archetype &arch = archetypes_[loc->archetype];
+    ComponentMask shared = sharedMaskFor(e);
+    if (arch.mask != (e.components | ComponentBase) || arch.sharedMask != shared ||
+        (shared != 0 && arch.prefab != e.prefab))
+    {
+        removeRow(*loc);
+        insertRow(e.id, e);
+        return true;
+    }
+
+    int row = loc->row;
+    arch.transforms[row] = e.transform;
+    if (arch.owns(ComponentRect))
+        arch.rects[row] = e.rect;
+    if (arch.owns(ComponentSprite))
+        arch.sprites[row] = e.sprite;
+    if (arch.owns(ComponentCollider))
+        arch.colliders[row] = e.collider;
+    if (arch.has(ComponentRigidBody))
+        arch.rigidbodies[row] = e.rigidbody;
+    if (arch.has(ComponentParent) && arch.parents[row].id != e.parent.id)
     {
-        if (e.id == id)
-            return &e;
+        arch.parents[row] = e.parent;
+        hierarchyVersion_++;
     }
-    return nullptr;
+    // world fica com o TransformSystem (carimbo de Transform dispara o recálculo)
+    arch.markChanged(arch.mask & ~ComponentWorldTransform, row, changeTick_);
+    writeVersion_++;
+    return true;
+}
+
+ComponentMask Scene::componentsOf(EntityId id) const
+{
+    const EntitySlot *loc = locate(id);
+    if (!loc)
+        return 0;
+    return archetypes_[loc->archetype].mask;
+}
+
+std::vector<EntityId> Scene::entityIds() const
+{
+    std::vector<EntityId> ids;
+    ids.reserve(entityCount_);
+    for (const auto &arch : archetypes_)
+        for (std::size_t i = 0; i < arch.size(); ++i)
+            ids.push_back(arch.ids[i]);
+    std::sort(ids.begin(), ids.end(),
+              [](EntityId a, EntityId b)
+              { return EntityIndex(a) < EntityIndex(b); });
+    return ids;
 }
 
 Tilemap &Scene::createTilemap(int width, int height, int tileSize)
@@ -31,27 +564,21 @@ Tilemap &Scene::createTilemap(int width, int height, int tileSize)
 
 void Scene::clear()
 {
-    entities_.clear();
-    nextEntityId_ = 1;
+    clearEntities();
+    prefabs_.clear();
     tilemaps_.clear();
     bounds_ = Bounds{};
 }
 
 void Scene::clearEntities()
 {
-    entities_.clear();
-    nextEntityId_ = 1;
-}
-
-bool Scene::destroyEntity(int id)
-{
-    for (size_t i = 0; i < entities_.size(); ++i)
-    {
-        if (entities_[i].id == id)
-        {
-            entities_.erase(entities_.begin() + (long)i);
-            return true;
-        }
-    }
-    return false;
+    archetypes_.clear();
+    archetypeByKey_.clear();
+    slots_.clear();
+    freeHead_ = 0;
+    freeTail_ = 0;
+    entityCount_ = 0;
+    structureVersion_++;
+    writeVersion_++;
+    hierarchyVersion_++;
 }
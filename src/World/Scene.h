@@ -1,5 +1,11 @@
 #pragma once
+#include <cassert>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
+#include "Archetype.h"
 #include "Entity.h"
 #include "Tilemap.h"
 
@@ -15,12 +21,142 @@ public:
         float h = 2000.0f;
     };
 
-    Entity &createEntity();
-    Entity *findEntity(int id);
-    std::vector<Entity> &entities() { return entities_; }
-    const std::vector<Entity> &entities() const { return entities_; }
-    bool destroyEntity(int id);
+    EntityId createEntity();
+    EntityId createEntity(const Entity &desc);
+    // Id reservado agora e criado depois (EntityCommandBuffer): sai da fila
+    // livre mas só fica vivo em createEntity(reserved, desc).
+    // releaseEntity devolve uma reserva que não vai ser usada.
+    EntityId reserveEntity();
+    EntityId createEntity(EntityId reserved, const Entity &desc);
+    void releaseEntity(EntityId reserved);
+    bool destroyEntity(EntityId id);
+    bool isAlive(EntityId id) const;
     void clearEntities();
+    // Garante espaço para count entidades novas com esse mask (spawn em lote).
+    void reserve(ComponentMask mask, std::size_t count);
+    // Idem, para o archetype em que desc cairia (instâncias de prefab).
+    void reserve(const Entity &desc, std::size_t count);
+
+    // Copia os componentes da entidade para um Entity (editor/save).
+    bool readEntity(EntityId id, Entity &out) const;
+    // Escreve de volta; se o mask mudou a entidade troca de archetype.
+    bool writeEntity(const Entity &e);
+    ComponentMask componentsOf(EntityId id) const;
+
+    // Hierarquia: o Transform do filho é relativo ao WorldTransform do pai.
+    // parent = InvalidEntity desanexa. Falha (false) se fecharia um ciclo.
+    // Se o pai for destruído os filhos passam a ser tratados como raízes.
+    bool setParent(EntityId child, EntityId parent);
+    // Pai vivo ou InvalidEntity.
+    EntityId parentOf(EntityId id) const;
+    // Muda quando alguma relação pai/filho pode ter mudado.
+    std::uint32_t hierarchyVersion() const { return hierarchyVersion_; }
+
+    // Archetype e linha da entidade (acesso por id nos sistemas), ou nullptr.
+    // A linha vale até a próxima mudança estrutural.
+    Archetype *archetypeOf(EntityId id, int &row);
+    const Archetype *archetypeOf(EntityId id, int &row) const;
+
+    // Prefabs: rect/sprite/collider ficam guardados uma vez e as instâncias
+    // só têm colunas para o resto (transform, rigidbody...). Escrever num
+    // componente compartilhado é explícito: override<T>(id), ou writeEntity
+    // com valor diferente, dá à instância uma cópia própria (copy-on-write).
+    // A instância troca de archetype: ponteiros e linhas que quem chama
+    // guardava deixam de valer. get<T> mutável não faz isso sozinho.
+    // Prefabs vivem até clear().
+    PrefabHandle createPrefab(const std::string &name, const Entity &desc,
+                              ComponentMask shared = ComponentShareable);
+    PrefabHandle findPrefab(const std::string &name) const;
+    // Entity pronto para instanciar: ajuste transform etc. e passe para
+    // createEntity (ou EntityCommandBuffer::create).
+    Entity prefabEntity(PrefabHandle prefab) const;
+    // Troca os dados do prefab; quem ainda compartilha passa a ver o novo valor.
+    bool updatePrefab(PrefabHandle prefab, const Entity &desc);
+    // Cria count instâncias de uma vez (reserva as colunas uma vez só).
+    // positions pode ser nullptr (usa o transform do prefab); outIds, se
+    // não for nullptr, recebe count ids. Devolve quantas foram criadas.
+    std::size_t instantiate(PrefabHandle prefab, std::size_t count,
+                            const Transform *positions, EntityId *outIds = nullptr);
+
+    // Acesso mutável carimba o componente como alterado no tick atual.
+    // Não muda a entidade de lugar: em componente compartilhado com o prefab
+    // devolve nullptr (assert em debug); para escrever nele use override<T>.
+    // Parent só muda por setParent/writeEntity (hierarchyVersion).
+    template <typename T>
+    T *get(EntityId id)
+    {
+        static_assert(!std::is_same<T, Parent>::value, "Scene::get<Parent> mutável: use setParent");
+        const EntitySlot *loc = locate(id);
+        if (!loc)
+            return nullptr;
+        if (archetypes_[loc->archetype].sharedMask & ComponentTraits<T>::bit)
+        {
+            assert(!"Scene::get<T> mutável em componente de prefab: use override<T>");
+            return nullptr;
+        }
+        Archetype &arch = archetypes_[loc->archetype];
+        if (!arch.has(ComponentTraits<T>::bit))
+            return nullptr;
+        arch.ticks<T>()[loc->row] = changeTick_;
+        writeVersion_++;
+        return &arch.column<T>()[loc->row];
+    }
+
+    // get<T> mutável que, se o componente é compartilhado com o prefab, antes
+    // dá à instância uma cópia própria (troca de archetype, ver Prefabs).
+    template <typename T>
+    T *override(EntityId id)
+    {
+        const EntitySlot *loc = locate(id);
+        if (loc && (archetypes_[loc->archetype].sharedMask & ComponentTraits<T>::bit))
+        {
+            if (!detachShared(id, ComponentTraits<T>::bit))
+                return nullptr;
+        }
+        return get<T>(id);
+    }
+
+    template <typename T>
+    const T *get(EntityId id) const
+    {
+        const EntitySlot *loc = locate(id);
+        if (!loc)
+            return nullptr;
+        const Archetype &arch = archetypes_[loc->archetype];
+        if (!arch.has(ComponentTraits<T>::bit))
+            return nullptr;
+        if constexpr ((ComponentTraits<T>::bit & ComponentShareable) != 0)
+        {
+            if (arch.sharedMask & ComponentTraits<T>::bit)
+                return &arch.shared->component<T>();
+        }
+        return &arch.column<T>()[loc->row];
+    }
+
+    // Change ticks: toda escrita (create, writeEntity, get<T> mutável, views
+    // mutáveis) carimba changeTick() nas linhas tocadas. Um sistema guarda o
+    // tick da última execução e filtra linhas com tick > esse valor.
+    // advanceChangeTick() devolve o tick atual e avança, então escritas
+    // posteriores sempre ficam acima do valor devolvido. O Engine avança o
+    // tick depois da geração de comandos de render (que só lê).
+    std::uint32_t changeTick() const { return changeTick_; }
+    std::uint32_t advanceChangeTick() { return changeTick_++; }
+
+    // Muda sempre que alguma linha é inserida/removida (ordem das views mudou).
+    std::uint32_t structureVersion() const { return structureVersion_; }
+
+    // Muda a cada escrita pela API do Scene (create/destroy, writeEntity,
+    // get<T> mutável, setParent, prefabs). Views mutáveis e eachChunk não
+    // contam: quem escreve por elas fora de um step chama noteWrite().
+    // Serve para pular refresh caro quando nada mudou.
+    std::uint32_t writeVersion() const { return writeVersion_; }
+    void noteWrite() { writeVersion_++; }
+
+    std::vector<Archetype> &archetypes() { return archetypes_; }
+    const std::vector<Archetype> &archetypes() const { return archetypes_; }
+    std::size_t entityCount() const { return entityCount_; }
+    std::vector<EntityId> entityIds() const;
+
     Bounds &bounds() { return bounds_; }
     const Bounds &bounds() const { return bounds_; }
 
@@ -30,8 +166,46 @@ public:
     void clear();
 
 private:
-    std::vector<Entity> entities_;
-    int nextEntityId_ = 1;
+    // Slot do índice da entidade: onde ela mora + geração atual. Slots livres
+    // formam uma fila (FIFO) para adiar ao máximo o reuso de cada índice.
+    struct EntitySlot
+    {
+        std::uint32_t generation = 0;
+        int archetype = -1;
+        int row = -1;
+        std::uint32_t nextFree = 0;
+        bool reserved = false; // fora da fila livre, ainda sem linha
+    };
+
+    struct PrefabSlot
+    {
+        std::string name;
+        std::shared_ptr<const Entity> data; // imutável: update troca o ponteiro
+        ComponentMask shared = 0;
+    };
+
+    const EntitySlot *locate(EntityId id) const;
+    int archetypeFor(ComponentMask mask, PrefabHandle prefab = InvalidPrefab, ComponentMask shared = 0);
+    ComponentMask sharedMaskFor(const Entity &desc) const;
+    bool detachShared(EntityId id, ComponentMask bits);
+    void reserveRows(Archetype &arch, std::size_t count);
+    void insertRow(EntityId id, const Entity &desc);
+    void removeRow(const EntitySlot &loc);
+    void freeSlot(std::uint32_t index);
+    bool hasHierarchy() const;
+
+private:
+    std::vector<Archetype> archetypes_;
+    std::unordered_map<std::uint64_t, int> archetypeByKey_; // mask + prefab + shared
+    std::vector<PrefabSlot> prefabs_;                      // handle = índice + 1
+    std::vector<EntitySlot> slots_; // indexado por EntityIndex(id); slot 0 reservado
+    std::uint32_t freeHead_ = 0;
+    std::uint32_t freeTail_ = 0;
+    std::size_t entityCount_ = 0;
+    std::uint32_t changeTick_ = 1;
+    std::uint32_t structureVersion_ = 0;
+    std::uint32_t writeVersion_ = 0;
+    std::uint32_t hierarchyVersion_ = 0;
     std::vector<Tilemap> tilemaps_;
     Bounds bounds_{};
 };
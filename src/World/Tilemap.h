@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <vector>
 
 struct Tilemap
@@ -9,6 +10,11 @@ struct Tilemap
     float originX = 0.0f;
     float originY = 0.0f;
     std::vector<int> tiles;
+    // Por tile id: 1 = bloqueia corpos no PhysicsSystem. Ids fora da
+    // tabela não são sólidos.
+    std::vector<unsigned char> solidIds;
+    // Muda a cada set/setSolid (a física refaz suas caixas de colisão).
+    std::uint32_t version = 0;
 
     bool inBounds(int x, int y) const
     {
@@ -27,5 +33,26 @@ struct Tilemap
         if (!inBounds(x, y))
             return;
         tiles[(y * width) + x] = value;
+        version++;
+    }
+
+    void setSolid(int id, bool solid)
+    {
+        if (id < 0)
+            return;
+        if (id >= (int)solidIds.size())
+            solidIds.resize(id + 1, 0);
+        solidIds[id] = solid ? 1 : 0;
+        version++;
+    }
+
+    bool isSolid(int id) const
+    {
+        return id >= 0 && id < (int)solidIds.size() && solidIds[id] != 0;
+    }
+
+    bool solidAt(int x, int y) const
+    {
+        return isSolid(get(x, y));
     }
 };
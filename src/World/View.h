@@ -0,0 +1,223 @@
+#pragma once
+#include <array>
+#include <cassert>
+#include <atomic>
+#include <type_traits>
+#include <vector>
+#include "../Engine/ThreadPool.h"
+#include "Scene.h"
+
+// Consulta tipada: View<Transform, const RigidBody2D>(scene) visita só os
+// archetypes que têm todos os componentes pedidos, chunk a chunk, com
+// ponteiros diretos para as colunas. O mask é resolvido em compilação.
+// Tipos const dão acesso só de leitura (e permitem usar um const Scene).
+// each/par_each carimbam o change tick dos componentes não-const visitados.
+// Componentes compartilhados por prefab só podem ser lidos. Uma View que
+// escreve em T e encontra instâncias com T compartilhado dispara assert
+// (debug); para pular essas instâncias de propósito chame skipShared(). Para
+// escrever nelas, Scene::override<T> dá a cópia própria antes.
+template <typename... Ts>
+class View
+{
+public:
+    static constexpr ComponentMask Mask = (ComponentTraits<std::remove_const_t<Ts>>::bit | ... | 0);
+    static constexpr ComponentMask WriteMask =
+        ((std::is_const_v<Ts> ? 0u : ComponentTraits<std::remove_const_t<Ts>>::bit) | ... | 0u);
+    static constexpr bool ReadOnly = (std::is_const_v<Ts> && ...);
+    static_assert((WriteMask & ComponentParent) == 0, "View com Parent mutável: use Scene::setParent");
+    using ArchetypeRef = std::conditional_t<ReadOnly, const Archetype, Archetype>;
+
+    explicit View(Scene &scene) : archetypes_(&scene.archetypes()), tick_(scene.changeTick()) {}
+    explicit View(const Scene &scene)
+        : archetypes_(const_cast<std::vector<Archetype> *>(&scene.archetypes()))
+    {
+        static_assert(ReadOnly, "View on const Scene needs const components");
+    }
+
+    // Pula archetypes que tenham qualquer um destes bits.
+    View &exclude(ComponentMask bits)
+    {
+        exclude_ |= bits;
+        return *this;
+    }
+
+    // Pula (sem assert) archetypes em que algum componente escrito pela View
+    // é compartilhado com o prefab.
+    View &skipShared()
+    {
+        skipShared_ = true;
+        return *this;
+    }
+
+    // each/par_each visitam só linhas em que algum dos bits mudou depois de
+    // since (ver Scene::changeTick).
+    View &changedSince(ComponentMask bits, std::uint32_t since)
+    {
+        changedBits_ = bits;
+        since_ = since;
+        return *this;
+    }
+
+    // fn(Archetype &, int chunk, int count, const EntityId *ids, Ts *...)
+    // Acesso cru: não filtra por changedSince nem carimba ticks; quem escreve
+    // marca as linhas em arch.ticks<T>(). Coluna compartilhada vem com um
+    // valor só: indexe com i * arch.step<T>().
+    template <typename Fn>
+    void eachChunk(Fn &&fn) const
+    {
+        for (auto &arch : *archetypes_)
+        {
+            if (!matches(arch))
+                continue;
+            for (int c = 0; c < arch.chunkCount(); ++c)
+                fn((ArchetypeRef &)arch, c, arch.chunkRows(c), (const EntityId *)arch.ids.chunk(c),
+                   columnChunk<Ts>(arch, c)...);
+        }
+    }
+
+    // fn(EntityId, Ts &...)
+    template <typename Fn>
+    void each(Fn &&fn) const
+    {
+        for (auto &arch : *archetypes_)
+        {
+            if (!matches(arch))
+                continue;
+            for (int c = 0; c < arch.chunkCount(); ++c)
+                runChunk(fn, arch, c);
+        }
+    }
+
+    // Como each(), um job por chunk no pool. fn roda em várias threads ao
+    // mesmo tempo: só pode escrever nos componentes da própria entidade.
+    template <typename Fn>
+    void par_each(ThreadPool &pool, Fn &&fn) const
+    {
+        std::atomic<int> remaining(0);
+        for (auto &arch : *archetypes_)
+        {
+            if (!matches(arch))
+                continue;
+            for (int c = 0; c < arch.chunkCount(); ++c)
+            {
+                remaining++;
+                pool.submit([this, &fn, &arch, c]()
+                            { runChunk(fn, arch, c); },
+                            &remaining);
+            }
+        }
+        pool.wait(remaining);
+    }
+
+    std::size_t count() const
+    {
+        std::size_t n = 0;
+        for (const auto &arch : *archetypes_)
+        {
+            if (matches(arch))
+                n += arch.size();
+        }
+        return n;
+    }
+
+private:
+    bool matches(const Archetype &arch) const
+    {
+        if (!arch.has(Mask) || (arch.mask & exclude_) != 0)
+            return false;
+        if ((arch.sharedMask & WriteMask) == 0)
+            return true;
+        // escrever aqui mudaria o valor de todas as instâncias do prefab
+        assert(skipShared_ && "View escreve em componente de prefab: skipShared() ou Scene::override<T>");
+        return false;
+    }
+
+    template <typename T>
+    static T *columnChunk(Archetype &arch, int c)
+    {
+        using U = std::remove_const_t<T>;
+        if constexpr (std::is_const_v<T> && (ComponentTraits<U>::bit & ComponentShareable) != 0)
+        {
+            if (arch.sharedMask & ComponentTraits<U>::bit)
+                return &arch.shared->template component<U>();
+        }
+        return arch.column<U>().chunk(c);
+    }
+
+    template <typename T>
+    struct ColumnRef
+    {
+        T *data;
+        int step;
+    };
+
+    template <typename T>
+    static ColumnRef<T> columnRef(Archetype &arch, int c)
+    {
+        return ColumnRef<T>{columnChunk<T>(arch, c), arch.step<std::remove_const_t<T>>()};
+    }
+
+    template <typename T>
+    static std::uint32_t *tickChunk(Archetype &arch, int c)
+    {
+        if constexpr (std::is_const_v<T>)
+            return nullptr;
+        else
+            return arch.ticks<T>().chunk(c);
+    }
+
+    template <typename Fn>
+    void runChunk(Fn &fn, Archetype &arch, int c) const
+    {
+        int count = arch.chunkRows(c);
+        const EntityId *ids = arch.ids.chunk(c);
+        std::array<std::uint32_t *, sizeof...(Ts)> stamps = {tickChunk<Ts>(arch, c)...};
+
+        // colunas de tick usadas pelo filtro changedSince
+        std::array<const std::uint32_t *, ComponentTypeCount> filter{};
+        int filterCount = 0;
+        ComponentMask bits = changedBits_ & arch.mask;
+        for (int k = 0; k < ComponentTypeCount; ++k)
+        {
+            if (bits & (1u << k))
+                filter[filterCount++] = arch.changeTicks[k].chunk(c);
+        }
+        if (changedBits_ != 0 && filterCount == 0)
+            return; // nenhum dos componentes filtrados existe aqui
+
+        runRows(fn, count, ids, stamps, filter, filterCount, columnRef<Ts>(arch, c)...);
+    }
+
+    template <typename Fn>
+    void runRows(Fn &fn, int count, const EntityId *ids,
+                 const std::array<std::uint32_t *, sizeof...(Ts)> &stamps,
+                 const std::array<const std::uint32_t *, ComponentTypeCount> &filter, int filterCount,
+                 ColumnRef<Ts>... cols) const
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            if (filterCount > 0)
+            {
+                bool changed = false;
+                for (int k = 0; k < filterCount && !changed; ++k)
+                    changed = filter[k][i] > since_;
+                if (!changed)
+                    continue;
+            }
+            for (std::uint32_t *ticks : stamps)
+            {
+                if (ticks)
+                    ticks[i] = tick_;
+            }
+            fn(ids[i], cols.data[i * cols.step]...);
+        }
+    }
+
+private:
+    std::vector<Archetype> *archetypes_;
+    std::uint32_t tick_ = 0;
+    ComponentMask exclude_ = 0;
+    ComponentMask changedBits_ = 0;
+    std::uint32_t since_ = 0;
+    bool skipShared_ = false;
+};
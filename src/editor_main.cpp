@@ -3,6 +3,7 @@
 #include "Game/SandboxScenes.h"
 #include "Assets/Texture.h"
 #include "World/SceneManager.h"
+#include "World/View.h"
 #include <SDL.h>
 #include <algorithm>
 #include <cstdio>
@@ -11,6 +12,7 @@
 #include <sstream>
 #include <cmath>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <imgui.h>
@@ -19,7 +21,7 @@
 
 static std::string ToLower(const std::string &s);
 static bool IsTextureExt(const std::string &ext);
-static void ClampEntityToBounds(const Scene::Bounds &b, Entity &e);
+static void ClampEntityToBounds(const Scene::Bounds &b, Transform &t);
 
 static void DrawFileTree(const std::filesystem::path &root, std::string &selectedPath, bool allowDrag)
 {
@@ -289,32 +291,37 @@ enum class BoundsType
     Sprite
 };
 
-static bool GetEntityBounds(const Entity &e, float &x, float &y, float &w, float &h, BoundsType &type)
+// Bounds em coordenadas de mundo (usa o WorldTransform cacheado da cena).
+static bool GetEntityBounds(const Scene &scene, const Entity &e, const AssetManager &assets, float &x, float &y, float &w, float &h, BoundsType &type)
 {
-    if (e.collider.enabled)
+    const WorldTransform *world = scene.get<WorldTransform>(e.id);
+    float px = world ? world->x : e.transform.x;
+    float py = world ? world->y : e.transform.y;
+    if (e.has(ComponentCollider))
     {
-        x = e.transform.x + e.collider.offsetX;
-        y = e.transform.y + e.collider.offsetY;
+        x = px + e.collider.offsetX;
+        y = py + e.collider.offsetY;
         w = e.collider.w;
         h = e.collider.h;
         type = BoundsType::Collider;
         return true;
     }
-    if (e.rect.enabled)
+    if (e.has(ComponentRect))
     {
-        x = e.transform.x;
-        y = e.transform.y;
+        x = px;
+        y = py;
         w = (float)e.rect.w;
         h = (float)e.rect.h;
         type = BoundsType::Rect;
         return true;
     }
-    if (e.sprite.enabled && e.sprite.texture)
+    const Texture *tex = e.has(ComponentSprite) ? assets.texture(e.sprite.texture) : nullptr;
+    if (tex)
     {
-        x = e.transform.x;
-        y = e.transform.y;
-        w = (float)e.sprite.texture->width() * e.sprite.scale;
-        h = (float)e.sprite.texture->height() * e.sprite.scale;
+        x = px;
+        y = py;
+        w = (float)tex->width() * e.sprite.scale;
+        h = (float)tex->height() * e.sprite.scale;
         type = BoundsType::Sprite;
         return true;
     }
@@ -322,48 +329,44 @@ static bool GetEntityBounds(const Entity &e, float &x, float &y, float &w, float
     return false;
 }
 
-static bool PickEntityAt(Scene &scene, float wx, float wy, int &outId)
+static bool PickEntityAt(Engine &engine, float wx, float wy, EntityId &outId)
 {
+    const Scene &scene = engine.scene();
     float bestArea = 0.0f;
-    int bestId = 0;
+    EntityId bestId = InvalidEntity;
 
-    for (const auto &e : scene.entities())
+    auto consider = [&](EntityId id, float x, float y, float w, float h)
     {
-        bool hit = false;
-        float x = 0.0f;
-        float y = 0.0f;
-        float w = 0.0f;
-        float h = 0.0f;
-
-        if (e.collider.enabled)
-        {
-            x = e.transform.x + e.collider.offsetX;
-            y = e.transform.y + e.collider.offsetY;
-            w = e.collider.w;
-            h = e.collider.h;
-            hit = PointInRect(wx, wy, x, y, w, h);
-        }
-        else if (e.rect.enabled)
+        if (!PointInRect(wx, wy, x, y, w, h))
+            return;
+        float area = w * h;
+        if (bestId == InvalidEntity || area < bestArea)
         {
-            x = e.transform.x;
-            y = e.transform.y;
-            w = (float)e.rect.w;
-            h = (float)e.rect.h;
-            hit = PointInRect(wx, wy, x, y, w, h);
+            bestArea = area;
+            bestId = id;
         }
+    };
 
-        if (hit)
-        {
-            float area = w * h;
-            if (bestId == 0 || area < bestArea)
-            {
-                bestArea = area;
-                bestId = e.id;
-            }
-        }
+    // Colliders pela consulta da física (o editor move entidades sem step;
+    // o refresh só refaz se o scene mudou). Rect sem collider fica na
+    // varredura linear de propósito: são poucos (fundo, UI) e um clique
+    // não justifica manter outro índice.
+    PhysicsSystem &physics = engine.physics();
+    physics.refreshQueries(engine.scene());
+    std::vector<EntityId> hits;
+    physics.overlapPoint(wx, wy, hits);
+    for (EntityId id : hits)
+    {
+        const WorldTransform *t = scene.get<WorldTransform>(id);
+        const ColliderAABB *c = scene.get<ColliderAABB>(id);
+        if (t && c)
+            consider(id, t->x + c->offsetX, t->y + c->offsetY, c->w, c->h);
     }
+    View<const WorldTransform, const RectRender>(scene).exclude(ComponentCollider).each(
+        [&](EntityId id, const WorldTransform &t, const RectRender &r)
+        { consider(id, t.x, t.y, (float)r.w, (float)r.h); });
 
-    if (bestId != 0)
+    if (bestId != InvalidEntity)
     {
         outId = bestId;
         return true;
@@ -379,7 +382,7 @@ static float SnapValue(float v, float step)
     return std::round(v * inv) / inv;
 }
 
-static bool SaveScene(const Scene &scene, const Camera2D &cam, const std::string &path)
+static bool SaveScene(const Scene &scene, const AssetManager &assets, const Camera2D &cam, const std::string &path)
 {
     std::ofstream out(path, std::ios::trunc);
     if (!out.is_open())
@@ -392,31 +395,32 @@ static bool SaveScene(const Scene &scene, const Camera2D &cam, const std::string
         << ", \"w\": " << scene.bounds().w << ", \"h\": " << scene.bounds().h << "},\n";
     out << "  \"entities\": [\n";
 
-    const auto &entities = scene.entities();
-    for (size_t i = 0; i < entities.size(); ++i)
+    const std::vector<EntityId> ids = scene.entityIds();
+    for (size_t i = 0; i < ids.size(); ++i)
     {
-        const auto &e = entities[i];
+        Entity e;
+        scene.readEntity(ids[i], e);
         out << "    {\n";
         out << "      \"id\": " << e.id << ",\n";
         out << "      \"x\": " << e.transform.x << ", \"y\": " << e.transform.y << ",\n";
-        out << "      \"rect\": {\"enabled\": " << (e.rect.enabled ? "true" : "false")
+        out << "      \"rect\": {\"enabled\": " << (e.has(ComponentRect) ? "true" : "false")
             << ", \"w\": " << e.rect.w << ", \"h\": " << e.rect.h
             << ", \"r\": " << (int)e.rect.r << ", \"g\": " << (int)e.rect.g
             << ", \"b\": " << (int)e.rect.b << ", \"a\": " << (int)e.rect.a << "},\n";
-        out << "      \"sprite\": {\"enabled\": " << (e.sprite.enabled ? "true" : "false")
+        out << "      \"sprite\": {\"enabled\": " << (e.has(ComponentSprite) ? "true" : "false")
             << ", \"scale\": " << e.sprite.scale << ", \"rot\": " << e.sprite.rotationDeg;
-        if (e.sprite.texture)
-            out << ", \"path\": \"" << e.sprite.texture->path() << "\"";
+        if (const Texture *tex = assets.texture(e.sprite.texture))
+            out << ", \"path\": \"" << tex->path() << "\"";
         out << "},\n";
-        out << "      \"collider\": {\"enabled\": " << (e.collider.enabled ? "true" : "false")
+        out << "      \"collider\": {\"enabled\": " << (e.has(ComponentCollider) ? "true" : "false")
             << ", \"w\": " << e.collider.w << ", \"h\": " << e.collider.h
             << ", \"offX\": " << e.collider.offsetX << ", \"offY\": " << e.collider.offsetY
             << ", \"trigger\": " << (e.collider.isTrigger ? "true" : "false") << "},\n";
-        out << "      \"rigidbody\": {\"enabled\": " << (e.rigidbody.enabled ? "true" : "false")
+        out << "      \"rigidbody\": {\"enabled\": " << (e.has(ComponentRigidBody) ? "true" : "false")
             << ", \"vx\": " << e.rigidbody.vx << ", \"vy\": " << e.rigidbody.vy
             << ", \"kin\": " << (e.rigidbody.isKinematic ? "true" : "false") << "}\n";
         out << "    }";
-        if (i + 1 < entities.size())
+        if (i + 1 < ids.size())
             out << ",";
         out << "\n";
     }
@@ -634,11 +638,12 @@ static bool LoadScene(Scene &scene, AssetManager &assets, Camera2D &cam, const s
     scene.clearEntities();
     for (const auto &snap : list)
     {
-        Entity &e = scene.createEntity();
+        Entity e;
         e.transform.x = snap.x;
         e.transform.y = snap.y;
 
-        e.rect.enabled = snap.rectEnabled;
+        if (snap.rectEnabled)
+            e.add(ComponentRect);
         e.rect.w = snap.rectW;
         e.rect.h = snap.rectH;
         e.rect.r = (unsigned char)snap.rectR;
@@ -646,25 +651,28 @@ static bool LoadScene(Scene &scene, AssetManager &assets, Camera2D &cam, const s
         e.rect.b = (unsigned char)snap.rectB;
         e.rect.a = (unsigned char)snap.rectA;
 
-        e.sprite.enabled = snap.spriteEnabled;
+        if (snap.spriteEnabled)
+            e.add(ComponentSprite);
         e.sprite.scale = snap.spriteScale;
         e.sprite.rotationDeg = snap.spriteRot;
         if (!snap.spritePath.empty())
             e.sprite.texture = assets.loadTexture(snap.spritePath);
-        else
-            e.sprite.texture.reset();
 
-        e.collider.enabled = snap.colliderEnabled;
+        if (snap.colliderEnabled)
+            e.add(ComponentCollider);
         e.collider.w = snap.colW;
         e.collider.h = snap.colH;
         e.collider.offsetX = snap.colOffX;
         e.collider.offsetY = snap.colOffY;
         e.collider.isTrigger = snap.colTrigger;
 
-        e.rigidbody.enabled = snap.rbEnabled;
+        if (snap.rbEnabled)
+            e.add(ComponentRigidBody);
         e.rigidbody.vx = snap.rbVx;
         e.rigidbody.vy = snap.rbVy;
         e.rigidbody.isKinematic = snap.rbKin;
+
+        scene.createEntity(e);
     }
 
     return true;
@@ -821,34 +829,41 @@ static void CreatePrefabScripts(const std::string &root)
 
 static void CreateEntityFromSprite(Scene &scene, AssetManager &assets, const std::string &path, float wx, float wy)
 {
-    auto tex = assets.loadTexture(path);
-    if (!tex)
-        return;
-    Entity &e = scene.createEntity();
+    // um prefab por textura: sprite e collider ficam compartilhados
+    PrefabHandle prefab = scene.findPrefab(path);
+    if (prefab == InvalidPrefab)
+    {
+        TextureHandle handle = assets.loadTexture(path);
+        const Texture *tex = assets.texture(handle);
+        if (!tex)
+            return;
+        Entity p;
+        p.sprite.texture = handle;
+        p.sprite.scale = 1.0f;
+        p.collider.w = (float)tex->width();
+        p.collider.h = (float)tex->height();
+        p.add(ComponentSprite | ComponentCollider);
+        prefab = scene.createPrefab(path, p);
+    }
+    Entity e = scene.prefabEntity(prefab);
     e.transform.x = wx;
     e.transform.y = wy;
-    e.sprite.texture = tex;
-    e.sprite.enabled = true;
-    e.sprite.scale = 1.0f;
-    e.rect.enabled = false;
-    e.collider.enabled = true;
-    e.collider.w = (float)tex->width();
-    e.collider.h = (float)tex->height();
-    ClampEntityToBounds(scene.bounds(), e);
+    ClampEntityToBounds(scene.bounds(), e.transform);
+    scene.createEntity(e);
 }
 
-static void ClampEntityToBounds(const Scene::Bounds &b, Entity &e)
+static void ClampEntityToBounds(const Scene::Bounds &b, Transform &t)
 {
     if (!b.enabled)
         return;
-    if (e.transform.x < b.x)
-        e.transform.x = b.x;
-    if (e.transform.y < b.y)
-        e.transform.y = b.y;
-    if (e.transform.x > (b.x + b.w))
-        e.transform.x = b.x + b.w;
-    if (e.transform.y > (b.y + b.h))
-        e.transform.y = b.y + b.h;
+    if (t.x < b.x)
+        t.x = b.x;
+    if (t.y < b.y)
+        t.y = b.y;
+    if (t.x > (b.x + b.w))
+        t.x = b.x + b.w;
+    if (t.y > (b.y + b.h))
+        t.y = b.y + b.h;
 }
 
 int main()
@@ -883,7 +898,7 @@ int main()
     };
     PlayState playState = PlayState::Stopped;
     std::string selectedPath;
-    int selectedEntityId = 0;
+    EntityId selectedEntityId = InvalidEntity;
     std::string importStatus = "Drop files into the window to import.";
     std::vector<std::string> pendingDrops;
     char importSubdirBuf[128] = {};
@@ -901,7 +916,7 @@ int main()
     bool draggingMove = false;
     bool draggingScale = false;
     bool draggingRotate = false;
-    int dragEntityId = 0;
+    EntityId dragEntityId = InvalidEntity;
     float dragOffsetX = 0.0f;
     float dragOffsetY = 0.0f;
     BoundsType dragType = BoundsType::None;
@@ -913,7 +928,7 @@ int main()
     float snapRotate = 15.0f;
     bool camFollowEntity = false;
     bool camLockPos = false;
-    int camFollowId = 0;
+    EntityId camFollowId = InvalidEntity;
     float camLockX = 0.0f;
     float camLockY = 0.0f;
     bool camClampToBounds = false;
@@ -989,11 +1004,11 @@ int main()
 
             if (camFollowEntity)
             {
-                Entity *e = engine.scene().findEntity(camFollowId);
-                if (e)
+                const WorldTransform *t = std::as_const(scene).get<WorldTransform>(camFollowId);
+                if (t)
                 {
-                    cam.x = e->transform.x;
-                    cam.y = e->transform.y;
+                    cam.x = t->x;
+                    cam.y = t->y;
                 }
             }
             else if (camLockPos)
@@ -1076,63 +1091,68 @@ int main()
                 scene.clearEntities();
                 for (const auto &snap : playSnapshot)
                 {
-                    Entity &e = scene.createEntity();
+                    Entity e;
                     e.transform.x = snap.x;
                     e.transform.y = snap.y;
-                    e.rect.enabled = snap.rectEnabled;
+                    if (snap.rectEnabled)
+                        e.add(ComponentRect);
                     e.rect.w = snap.rectW;
                     e.rect.h = snap.rectH;
                     e.rect.r = (unsigned char)snap.rectR;
                     e.rect.g = (unsigned char)snap.rectG;
                     e.rect.b = (unsigned char)snap.rectB;
                     e.rect.a = (unsigned char)snap.rectA;
-                    e.sprite.enabled = snap.spriteEnabled;
+                    if (snap.spriteEnabled)
+                        e.add(ComponentSprite);
                     e.sprite.scale = snap.spriteScale;
                     e.sprite.rotationDeg = snap.spriteRot;
                     if (!snap.spritePath.empty())
                         e.sprite.texture = engine.assets().loadTexture(snap.spritePath);
-                    else
-                        e.sprite.texture.reset();
-                    e.collider.enabled = snap.colliderEnabled;
+                    if (snap.colliderEnabled)
+                        e.add(ComponentCollider);
                     e.collider.w = snap.colW;
                     e.collider.h = snap.colH;
                     e.collider.offsetX = snap.colOffX;
                     e.collider.offsetY = snap.colOffY;
                     e.collider.isTrigger = snap.colTrigger;
-                    e.rigidbody.enabled = snap.rbEnabled;
+                    if (snap.rbEnabled)
+                        e.add(ComponentRigidBody);
                     e.rigidbody.vx = snap.rbVx;
                     e.rigidbody.vy = snap.rbVy;
                     e.rigidbody.isKinematic = snap.rbKin;
+                    scene.createEntity(e);
                 }
                 engine.camera() = playSnapshotCam;
             }
             else
             {
                 playSnapshot.clear();
-                for (const auto &e : scene.entities())
+                for (EntityId id : scene.entityIds())
                 {
+                    Entity e;
+                    scene.readEntity(id, e);
                     EntitySnapshot snap{};
                     snap.x = e.transform.x;
                     snap.y = e.transform.y;
-                    snap.rectEnabled = e.rect.enabled;
+                    snap.rectEnabled = e.has(ComponentRect);
                     snap.rectW = e.rect.w;
                     snap.rectH = e.rect.h;
                     snap.rectR = e.rect.r;
                     snap.rectG = e.rect.g;
                     snap.rectB = e.rect.b;
                     snap.rectA = e.rect.a;
-                    snap.spriteEnabled = e.sprite.enabled;
+                    snap.spriteEnabled = e.has(ComponentSprite);
                     snap.spriteScale = e.sprite.scale;
                     snap.spriteRot = e.sprite.rotationDeg;
-                    if (e.sprite.texture)
-                        snap.spritePath = e.sprite.texture->path();
-                    snap.colliderEnabled = e.collider.enabled;
+                    if (const Texture *tex = engine.assets().texture(e.sprite.texture))
+                        snap.spritePath = tex->path();
+                    snap.colliderEnabled = e.has(ComponentCollider);
                     snap.colW = e.collider.w;
                     snap.colH = e.collider.h;
                     snap.colOffX = e.collider.offsetX;
                     snap.colOffY = e.collider.offsetY;
                     snap.colTrigger = e.collider.isTrigger;
-                    snap.rbEnabled = e.rigidbody.enabled;
+                    snap.rbEnabled = e.has(ComponentRigidBody);
                     snap.rbVx = e.rigidbody.vx;
                     snap.rbVy = e.rigidbody.vy;
                     snap.rbKin = e.rigidbody.isKinematic;
@@ -1162,7 +1182,7 @@ int main()
         ImGui::SameLine();
         if (ImGui::Button("Save"))
         {
-            savedOk = SaveScene(engine.scene(), engine.camera(), savePathBuf);
+            savedOk = SaveScene(engine.scene(), engine.assets(), engine.camera(), savePathBuf);
             importStatus = savedOk ? "Scene saved." : "Failed to save scene.";
         }
         ImGui::SameLine();
@@ -1226,7 +1246,7 @@ int main()
             project.name = projectNameBuf;
             if (project.scenePath.empty())
                 project.scenePath = "assets/editor_scene.json";
-            bool ok = SaveScene(scene, engine.camera(), savePathBuf) && WriteProjectFile(project);
+            bool ok = SaveScene(scene, engine.assets(), engine.camera(), savePathBuf) && WriteProjectFile(project);
             projectStatus = ok ? "Project saved." : "Failed to save project.";
         }
         ImGui::SameLine();
@@ -1347,60 +1367,67 @@ int main()
         ImGui::Text("Entities");
         if (ImGui::Button("Add Entity"))
         {
-            Entity &e = engine.scene().createEntity();
+            Entity e;
             e.transform.x = engine.camera().x;
             e.transform.y = engine.camera().y;
-            e.rect.enabled = true;
             e.rect.w = 32;
             e.rect.h = 32;
-            selectedEntityId = e.id;
+            e.add(ComponentRect);
+            selectedEntityId = engine.scene().createEntity(e);
         }
         ImGui::SameLine();
-        if (ImGui::Button("Delete") && selectedEntityId != 0)
+        if (ImGui::Button("Delete") && selectedEntityId != InvalidEntity)
         {
             engine.scene().destroyEntity(selectedEntityId);
-            selectedEntityId = 0;
+            selectedEntityId = InvalidEntity;
         }
-        for (const auto &e : engine.scene().entities())
+        for (EntityId id : engine.scene().entityIds())
         {
-            std::string label = "Entity " + std::to_string(e.id);
-            bool selected = (selectedEntityId == e.id);
+            std::string label = "Entity " + std::to_string(EntityIndex(id));
+            if (EntityGeneration(id) != 0)
+                label += "." + std::to_string(EntityGeneration(id));
+            bool selected = (selectedEntityId == id);
             if (ImGui::Selectable(label.c_str(), selected))
-                selectedEntityId = e.id;
+                selectedEntityId = id;
         }
         ImGui::Separator();
-        Entity *selected = engine.scene().findEntity(selectedEntityId);
-        if (selected)
+        Entity selected;
+        if (engine.scene().readEntity(selectedEntityId, selected))
         {
+            bool changed = false;
             ImGui::Text("Transform");
-            ImGui::InputFloat("X", &selected->transform.x);
-            ImGui::InputFloat("Y", &selected->transform.y);
+            changed |= ImGui::InputFloat("X", &selected.transform.x);
+            changed |= ImGui::InputFloat("Y", &selected.transform.y);
 
             ImGui::Separator();
             ImGui::Text("RectRender");
-            ImGui::Checkbox("Rect Enabled", &selected->rect.enabled);
-            ImGui::InputInt("Rect W", &selected->rect.w);
-            ImGui::InputInt("Rect H", &selected->rect.h);
+            changed |= ImGui::CheckboxFlags("Rect Enabled", &selected.components, ComponentRect);
+            changed |= ImGui::InputInt("Rect W", &selected.rect.w);
+            changed |= ImGui::InputInt("Rect H", &selected.rect.h);
 
             ImGui::Separator();
             ImGui::Text("SpriteRender");
-            ImGui::Checkbox("Sprite Enabled", &selected->sprite.enabled);
-            ImGui::InputFloat("Sprite Scale", &selected->sprite.scale);
-            ImGui::InputFloat("Sprite Rotation", &selected->sprite.rotationDeg);
+            changed |= ImGui::CheckboxFlags("Sprite Enabled", &selected.components, ComponentSprite);
+            changed |= ImGui::InputFloat("Sprite Scale", &selected.sprite.scale);
+            changed |= ImGui::InputFloat("Sprite Rotation", &selected.sprite.rotationDeg);
 
             ImGui::Separator();
             ImGui::Text("Collider");
-            ImGui::Checkbox("Collider Enabled", &selected->collider.enabled);
-            ImGui::InputFloat("Collider W", &selected->collider.w);
-            ImGui::InputFloat("Collider H", &selected->collider.h);
-            ImGui::Checkbox("Is Trigger", &selected->collider.isTrigger);
+            changed |= ImGui::CheckboxFlags("Collider Enabled", &selected.components, ComponentCollider);
+            changed |= ImGui::InputFloat("Collider W", &selected.collider.w);
+            changed |= ImGui::InputFloat("Collider H", &selected.collider.h);
+            changed |= ImGui::Checkbox("Is Trigger", &selected.collider.isTrigger);
 
             ImGui::Separator();
             ImGui::Text("RigidBody2D");
-            ImGui::Checkbox("RB Enabled", &selected->rigidbody.enabled);
-            ImGui::Checkbox("Kinematic", &selected->rigidbody.isKinematic);
-            ImGui::InputFloat("Vel X", &selected->rigidbody.vx);
-            ImGui::InputFloat("Vel Y", &selected->rigidbody.vy);
+            changed |= ImGui::CheckboxFlags("RB Enabled", &selected.components, ComponentRigidBody);
+            changed |= ImGui::Checkbox("Kinematic", &selected.rigidbody.isKinematic);
+            changed |= ImGui::InputFloat("Vel X", &selected.rigidbody.vx);
+            changed |= ImGui::InputFloat("Vel Y", &selected.rigidbody.vy);
+
+            // o componente existe ou não: o inspector edita uma cópia e devolve
+            if (changed)
+                engine.scene().writeEntity(selected);
         }
         ImGui::End();
 
@@ -1477,8 +1504,8 @@ int main()
                 haveMouseWorld = true;
                 if (!draggingMove && !draggingScale && !draggingRotate && ImGui::IsMouseClicked(0))
                 {
-                    int pickedId = 0;
-                    if (PickEntityAt(engine.scene(), mouseWorldX, mouseWorldY, pickedId))
+                    EntityId pickedId = InvalidEntity;
+                    if (PickEntityAt(engine, mouseWorldX, mouseWorldY, pickedId))
                         selectedEntityId = pickedId;
                 }
                 if (playState != PlayState::Playing && ImGui::IsMouseDragging(1))
@@ -1533,7 +1560,7 @@ int main()
         ImGui::InputFloat("Rotate Step", &snapRotate);
         ImGui::Separator();
         ImGui::Text("Camera Lock");
-        if (ImGui::Button("Follow Selected") && selectedEntityId != 0)
+        if (ImGui::Button("Follow Selected") && selectedEntityId != InvalidEntity)
         {
             camFollowEntity = true;
             camLockPos = false;
@@ -1578,12 +1605,13 @@ int main()
                 dl->AddRect(b0, b1, IM_COL32(120, 180, 255, 180), 0.0f, 0, 2.0f);
             }
 
-            if (selectedEntityId != 0)
+            if (selectedEntityId != InvalidEntity)
             {
-                Entity *selectedEnt = engine.scene().findEntity(selectedEntityId);
+                Entity selectedEnt;
+                bool haveSelected = engine.scene().readEntity(selectedEntityId, selectedEnt);
                 float bx = 0.0f, by = 0.0f, bw = 0.0f, bh = 0.0f;
                 BoundsType btype = BoundsType::None;
-                if (selectedEnt && GetEntityBounds(*selectedEnt, bx, by, bw, bh, btype))
+                if (haveSelected && GetEntityBounds(engine.scene(), selectedEnt, engine.assets(), bx, by, bw, bh, btype))
                 {
                     float sx0 = 0.0f, sy0 = 0.0f, sx1 = 0.0f, sy1 = 0.0f;
                     WorldToScreen(cam, bx, by, sceneTexW, sceneTexH, sx0, sy0);
@@ -1622,8 +1650,8 @@ int main()
                             draggingScale = false;
                             draggingRotate = false;
                             dragEntityId = selectedEntityId;
-                            dragOffsetX = mouseWorldX - selectedEnt->transform.x;
-                            dragOffsetY = mouseWorldY - selectedEnt->transform.y;
+                            dragOffsetX = mouseWorldX - selectedEnt.transform.x;
+                            dragOffsetY = mouseWorldY - selectedEnt.transform.y;
                         }
                         else if (overScale)
                         {
@@ -1639,7 +1667,7 @@ int main()
                             draggingMove = false;
                             draggingScale = false;
                             dragEntityId = selectedEntityId;
-                            dragStartRot = selectedEnt->sprite.rotationDeg;
+                            dragStartRot = selectedEnt.sprite.rotationDeg;
                             dragStartAngle = std::atan2(mouseWorldY - (by + bh * 0.5f), mouseWorldX - (bx + bw * 0.5f));
                         }
                     }
@@ -1651,17 +1679,18 @@ int main()
                         bool lockX = ImGui::GetIO().KeyShift;
                         bool lockY = ImGui::GetIO().KeyCtrl;
                         if (lockX)
-                            newY = selectedEnt->transform.y;
+                            newY = selectedEnt.transform.y;
                         if (lockY)
-                            newX = selectedEnt->transform.x;
+                            newX = selectedEnt.transform.x;
                         if (snapEnabled)
                         {
                             newX = SnapValue(newX, snapMove);
                             newY = SnapValue(newY, snapMove);
                         }
-                        selectedEnt->transform.x = newX;
-                        selectedEnt->transform.y = newY;
-                        ClampEntityToBounds(scene.bounds(), *selectedEnt);
+                        selectedEnt.transform.x = newX;
+                        selectedEnt.transform.y = newY;
+                        ClampEntityToBounds(scene.bounds(), selectedEnt.transform);
+                        engine.scene().writeEntity(selectedEnt);
                         if (ImGui::IsMouseReleased(0))
                             draggingMove = false;
                     }
@@ -1680,29 +1709,31 @@ int main()
                             newH = SnapValue(newH, snapScale);
                         }
 
+                        const Texture *spriteTex = engine.assets().texture(selectedEnt.sprite.texture);
                         if (dragType == BoundsType::Rect)
                         {
-                            selectedEnt->rect.w = (int)newW;
-                            selectedEnt->rect.h = (int)newH;
+                            selectedEnt.rect.w = (int)newW;
+                            selectedEnt.rect.h = (int)newH;
                         }
                         else if (dragType == BoundsType::Collider)
                         {
-                            selectedEnt->collider.w = newW;
-                            selectedEnt->collider.h = newH;
+                            selectedEnt.collider.w = newW;
+                            selectedEnt.collider.h = newH;
                         }
-                        else if (dragType == BoundsType::Sprite && selectedEnt->sprite.texture)
+                        else if (dragType == BoundsType::Sprite && spriteTex)
                         {
-                            float baseW = (float)selectedEnt->sprite.texture->width();
-                            float baseH = (float)selectedEnt->sprite.texture->height();
+                            float baseW = (float)spriteTex->width();
+                            float baseH = (float)spriteTex->height();
                             float scaleW = newW / baseW;
                             float scaleH = newH / baseH;
                             float newScale = (scaleW > scaleH) ? scaleW : scaleH;
                             if (newScale < 0.05f)
                                 newScale = 0.05f;
-                            selectedEnt->sprite.scale = newScale;
+                            selectedEnt.sprite.scale = newScale;
                         }
 
-                        ClampEntityToBounds(scene.bounds(), *selectedEnt);
+                        ClampEntityToBounds(scene.bounds(), selectedEnt.transform);
+                        engine.scene().writeEntity(selectedEnt);
                         if (ImGui::IsMouseReleased(0))
                             draggingScale = false;
                     }
@@ -1713,8 +1744,9 @@ int main()
                         float deg = dragStartRot + (delta * 180.0f / 3.14159265f);
                         if (snapEnabled)
                             deg = SnapValue(deg, snapRotate);
-                        selectedEnt->sprite.rotationDeg = deg;
-                        ClampEntityToBounds(scene.bounds(), *selectedEnt);
+                        selectedEnt.sprite.rotationDeg = deg;
+                        ClampEntityToBounds(scene.bounds(), selectedEnt.transform);
+                        engine.scene().writeEntity(selectedEnt);
                         if (ImGui::IsMouseReleased(0))
                             draggingRotate = false;
                     }